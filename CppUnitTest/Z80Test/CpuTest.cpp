@@ -65,20 +65,20 @@ TEST(CpuStandalone, DISABLED_ConstructionDestructionNoSideEffects)
     BusMock memory;
     BusMock io;
 
-    EXPECT_CALL(memory, read(_)).Times(0);
-    EXPECT_CALL(memory, write(_, _)).Times(0);
-    EXPECT_CALL(io, read(_)).Times(0);
-    EXPECT_CALL(io, write(_, _)).Times(0);
+    EXPECT_CALL(memory, read(_, _)).Times(0);
+    EXPECT_CALL(memory, write(_, _, _)).Times(0);
+    EXPECT_CALL(io, read(_, _)).Times(0);
+    EXPECT_CALL(io, write(_, _, _)).Times(0);
 
     Cpu cpu(memory, io);
 }
 
 TEST_F(CpuTest, DISABLED_ResetNoSideEffects)
 {
-    EXPECT_CALL(memory, read(_)).Times(0);
-    EXPECT_CALL(memory, write(_, _)).Times(0);
-    EXPECT_CALL(io, read(_)).Times(0);
-    EXPECT_CALL(io, write(_, _)).Times(0);
+    EXPECT_CALL(memory, read(_, _)).Times(0);
+    EXPECT_CALL(memory, write(_, _, _)).Times(0);
+    EXPECT_CALL(io, read(_, _)).Times(0);
+    EXPECT_CALL(io, write(_, _, _)).Times(0);
 
     cpu->reset();
 }
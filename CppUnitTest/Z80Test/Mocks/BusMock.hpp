@@ -22,6 +22,6 @@
 class BusMock : public IBus
 {
   public:
-    MOCK_METHOD(int, read, (int), (const, final, override));
-    MOCK_METHOD(void, write, (int, int), (final, override));
+    MOCK_METHOD(int, read, (int, int), (const, final, override));
+    MOCK_METHOD(void, write, (int, int, int), (final, override));
 };
@@ -0,0 +1,135 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+#include "ZXSpectrum/AudioRing.hpp"
+#include "ZXSpectrum/RateControl.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(AudioRingTest, RoundsCapacityUpToPowerOfTwo)
+{
+    EXPECT_EQ(AudioRing(1000, 1).capacity(), 1024);
+    EXPECT_EQ(AudioRing(2048, 2).capacity(), 2048);
+}
+
+TEST(AudioRingTest, KeepsOrderAcrossTheWrap)
+{
+    AudioRing ring(8, 2);
+    std::vector<float> out(16);
+    float next = 0.0f;
+    float expected = 0.0f;
+    for (int round = 0; round < 10; round++)
+    {
+        std::vector<float> in(2 * 5);
+        for (float& sample : in)
+        {
+            sample = next++;
+        }
+        ASSERT_EQ(ring.write(in.data(), 5), 5);
+        EXPECT_EQ(ring.fill(), 5);
+        ASSERT_EQ(ring.read(out.data(), 5), 5);
+        for (int i = 0; i < 10; i++)
+        {
+            EXPECT_EQ(out[i], expected++);
+        }
+    }
+}
+
+TEST(AudioRingTest, StoresAndTakesOnlyWhatFits)
+{
+    AudioRing ring(4, 1);
+    const std::vector<float> in{1, 2, 3, 4, 5, 6};
+    EXPECT_EQ(ring.write(in.data(), 6), 4);
+    EXPECT_EQ(ring.write(in.data(), 1), 0);
+
+    std::vector<float> out(6);
+    EXPECT_EQ(ring.read(out.data(), 3), 3);
+    EXPECT_EQ(ring.write(in.data() + 4, 2), 2);
+    EXPECT_EQ(ring.read(out.data() + 3, 6), 3);
+    EXPECT_EQ(out, (std::vector<float>{1, 2, 3, 4, 5, 6}));
+    EXPECT_EQ(ring.read(out.data(), 1), 0);
+}
+
+TEST(AudioRingTest, HandsOverBetweenThreadsInOrder)
+{
+    constexpr int total{200000};
+    AudioRing ring(256, 2);
+    std::thread producer(
+        [&ring]
+        {
+            std::vector<float> in(2 * 37);
+            for (int sent = 0; sent < total;)
+            {
+                const int count = std::min(37, total - sent);
+                for (int i = 0; i < count; i++)
+                {
+                    in[2 * i] = float(sent + i);
+                    in[2 * i + 1] = -float(sent + i);
+                }
+                sent += int(ring.write(in.data(), count));
+            }
+        });
+
+    std::vector<float> out(2 * 53);
+    bool ordered = true;
+    for (int received = 0; received < total;)
+    {
+        const auto count = int(ring.read(out.data(), 53));
+        for (int i = 0; i < count; i++)
+        {
+            ordered &= out[2 * i] == float(received + i) && out[2 * i + 1] == -float(received + i);
+        }
+        received += count;
+    }
+    producer.join();
+    EXPECT_TRUE(ordered);
+}
+
+TEST(RateControlTest, StaysWithinItsLimits)
+{
+    RateControl full;
+    EXPECT_NEAR(full.update(1024, 512), 1.0 + RateControl::maxAdjust, 1e-12);
+    RateControl empty;
+    EXPECT_NEAR(empty.update(0, 512), 1.0 - RateControl::maxAdjust, 1e-12);
+    RateControl settled;
+    EXPECT_EQ(settled.update(512, 512), 1.0);
+}
+
+TEST(RateControlTest, TracksAHostThatRunsFast)
+{
+    // 882 samples a frame from the emulator, drained 0.3% faster: the
+    // ratio has to settle below one and the ring must never run dry.
+    constexpr double produced{882.0};
+    constexpr double consumed{produced * 1.003};
+    constexpr std::size_t target{2048};
+    RateControl control;
+    double fill = double(target);
+    double lowest = fill;
+    double ratio = 1.0;
+    for (int frame = 0; frame < 5000; frame++)
+    {
+        ratio = control.update(std::size_t(fill), target);
+        fill += produced / ratio - consumed;
+        lowest = std::min(lowest, fill);
+    }
+    EXPECT_GT(lowest, 0.0);
+    EXPECT_NEAR(ratio, 1.0 / 1.003, 1e-4);
+}
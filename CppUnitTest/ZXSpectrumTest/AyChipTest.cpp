@@ -0,0 +1,215 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/AyChip.hpp"
+#include "ZXSpectrum/BlepBuffer.hpp"
+#include "ZXSpectrum/Scheduler.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+class AyChipTest : public ::testing::Test
+{
+  protected:
+    static constexpr int frameCycles{70000};
+
+    AyChipTest() : audio{AyChip::cyclesPerTick, frameCycles}, ay{clock, audio, frameCycles}, samples(2 * 8192)
+    {
+    }
+
+    void writeAt(int cycles, int reg, int data)
+    {
+        clock.advance(cycles - clock.now());
+        ay.select(reg);
+        ay.write(data, 0);
+    }
+
+    std::vector<float> frame(bool stereo = false)
+    {
+        ay.endFrame();
+        audio.endFrame();
+        clock.rebase(frameCycles);
+        const auto count = audio.read(samples.data(), 8192, stereo);
+        return {samples.begin(), samples.begin() + count * (stereo ? 2 : 1)};
+    }
+
+    // Volume after steps envelope steps, straight from the shape table.
+    static int envelopeAt(int shape, int steps)
+    {
+        bool attack = (shape & 4) != 0;
+        const int cycle = steps / 16;
+        const int step = steps % 16;
+        if (cycle > 0 && (shape & 8) == 0)
+        {
+            return 0;
+        }
+        if (cycle > 0 && (shape & 1) != 0)
+        {
+            return attack != ((shape & 2) != 0) ? 15 : 0;
+        }
+        if ((shape & 2) != 0 && (cycle & 1) != 0)
+        {
+            attack = !attack;
+        }
+        return attack ? step : 15 - step;
+    }
+
+    static std::pair<float, float> peaks(const std::vector<float>& out)
+    {
+        float left = 0.0f;
+        float right = 0.0f;
+        for (std::size_t i = 0; i < out.size(); i += 2)
+        {
+            left = std::max(left, out[i]);
+            right = std::max(right, out[i + 1]);
+        }
+        return {left, right};
+    }
+
+    static int signChanges(const std::vector<float>& out)
+    {
+        int changes = 0;
+        for (std::size_t i = 1; i < out.size(); i++)
+        {
+            changes += (out[i - 1] < 0.0f) != (out[i] < 0.0f);
+        }
+        return changes;
+    }
+
+    Scheduler clock;
+    BlepBuffer audio;
+    AyChip ay;
+    std::vector<float> samples;
+};
+
+TEST_F(AyChipTest, RegistersKeepTheirBits)
+{
+    constexpr std::array<int, AyChip::registerCount> expected{0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0x1F, 0xFF,
+                                                              0x1F, 0x1F, 0x1F, 0xFF, 0xFF, 0x0F, 0xFF, 0xFF};
+    for (int reg = 0; reg < AyChip::registerCount; reg++)
+    {
+        writeAt(reg, reg, 0xFF);
+        EXPECT_EQ(ay.read(), expected[reg]) << reg;
+    }
+
+    ay.select(16);
+    ay.write(0x12, 0);
+    EXPECT_EQ(ay.read(), 0xFF);
+}
+
+TEST_F(AyChipTest, WriteAtTheTstateOfTheOut)
+{
+    // A volume write eleven tstates into an instruction starting at 989.
+    writeAt(0, 7, 0x3F);
+    clock.advance(1000 - 11);
+    ay.select(8);
+    ay.write(15, 11);
+    const auto out = frame();
+
+    Scheduler otherClock;
+    BlepBuffer otherAudio{AyChip::cyclesPerTick, frameCycles};
+    AyChip other{otherClock, otherAudio, frameCycles};
+    other.select(7);
+    other.write(0x3F, 0);
+    otherClock.advance(1000);
+    other.select(8);
+    other.write(15, 0);
+    other.endFrame();
+    otherAudio.endFrame();
+    std::vector<float> expected(out.size());
+    otherAudio.read(expected.data(), std::uint32_t(expected.size()));
+
+    EXPECT_EQ(out, expected);
+}
+
+TEST_F(AyChipTest, SilentUntilAVolumeIsSet)
+{
+    writeAt(100, 7, 0x00);
+    writeAt(200, 6, 1);
+    const auto out = frame();
+
+    ASSERT_EQ(out.size(), 4375);
+    EXPECT_TRUE(std::all_of(out.begin(), out.end(), [](float sample) { return sample == 0.0f; }));
+}
+
+TEST_F(AyChipTest, VolumeWritesAreSteps)
+{
+    // Tone and noise off: the channel outputs its volume, which is how
+    // samples are played.
+    writeAt(0, 7, 0x3F);
+    writeAt(35000, 8, 15);
+    const auto out = frame();
+
+    const int edge = 2187 + BlepBuffer::taps / 2 - 1;
+    EXPECT_EQ(out[edge - BlepBuffer::taps / 2], 0.0f);
+    EXPECT_NEAR(*std::max_element(out.begin(), out.end()), 0.2f, 0.02f);
+}
+
+TEST_F(AyChipTest, ToneHasItsPeriod)
+{
+    // Period 100 flips every 1600 cycles: 43.75 times a frame.
+    writeAt(0, 0, 100);
+    writeAt(0, 7, 0x3E);
+    writeAt(0, 8, 15);
+
+    std::vector<float> out;
+    for (int i = 0; i < 5; i++)
+    {
+        out = frame();
+    }
+    EXPECT_NEAR(signChanges(out), 44, 2);
+}
+
+TEST_F(AyChipTest, EnvelopeFollowsEveryShape)
+{
+    for (int shape = 0; shape < 16; shape++)
+    {
+        // Period 1 steps every 32 cycles.
+        writeAt(0, 11, 1);
+        writeAt(0, 13, shape);
+        for (int steps = 0; steps < 64; steps++)
+        {
+            writeAt(steps * 32 + 1, 14, 0);
+            ASSERT_EQ(ay.envelope(), envelopeAt(shape, steps)) << "shape " << shape << " step " << steps;
+        }
+        frame();
+    }
+}
+
+TEST_F(AyChipTest, StereoLayoutPlacesChannels)
+{
+    ay.setLayout(AudioLayout::StereoABC);
+    writeAt(0, 7, 0x3F);
+    writeAt(1000, 10, 15);
+
+    const auto [left, right] = peaks(frame(true));
+    EXPECT_EQ(left, 0.0f);
+    EXPECT_GT(right, 0.3f);
+}
+
+TEST_F(AyChipTest, AcbPutsThirdChannelInMiddle)
+{
+    ay.setLayout(AudioLayout::StereoACB);
+    writeAt(0, 7, 0x3F);
+    writeAt(1000, 10, 15);
+
+    const auto [left, right] = peaks(frame(true));
+    EXPECT_GT(left, 0.1f);
+    EXPECT_EQ(left, right);
+}
@@ -0,0 +1,190 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/Beeper.hpp"
+#include "ZXSpectrum/BlepBuffer.hpp"
+#include "ZXSpectrum/Models.hpp"
+#include "ZXSpectrum/Scheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+template <typename Model> class BeeperTestBase : public ::testing::Test
+{
+  protected:
+    static constexpr int cyclesPerSample{16};
+
+    BeeperTestBase() : audio{cyclesPerSample, Model::totalFrameCycles}, beeper{clock, audio}, samples(16384)
+    {
+    }
+
+    void writeAt(int cycles, int data)
+    {
+        clock.advance(cycles - clock.now());
+        beeper.setLevel(data, 0);
+    }
+
+    std::vector<float> frame()
+    {
+        audio.endFrame();
+        clock.rebase(Model::totalFrameCycles);
+        const auto count = audio.read(samples.data(), std::uint32_t(samples.size()));
+        return {samples.begin(), samples.begin() + count};
+    }
+
+    Scheduler clock;
+    BlepBuffer audio;
+    Beeper beeper;
+    std::vector<float> samples;
+};
+
+using BeeperTest = BeeperTestBase<Model48K>;
+using Beeper128Test = BeeperTestBase<Model128K>;
+
+TEST_F(BeeperTest, SilentWithoutChanges)
+{
+    writeAt(1000, 0x07);
+    const auto out = frame();
+
+    // 70000 cycles is exactly 4375 samples.
+    ASSERT_EQ(out.size(), 4375);
+    EXPECT_TRUE(std::all_of(out.begin(), out.end(), [](float sample) { return sample == 0.0f; }));
+}
+
+TEST_F(BeeperTest, StepReachesItsHeight)
+{
+    writeAt(35000, 0x10);
+    const auto out = frame();
+
+    // 35000 cycles is sample 2187.5, and the step lands taps / 2 - 1 later.
+    const int edge = 2187 + BlepBuffer::taps / 2 - 1;
+    EXPECT_TRUE(std::all_of(out.begin(), out.begin() + edge - BlepBuffer::taps / 2,
+                            [](float sample) { return sample == 0.0f; }));
+    EXPECT_LT(out[edge - 1], 0.25f);
+    EXPECT_GT(out[edge + 1], 0.25f);
+    // Band-limited, so it rings a little above its height.
+    const float top = *std::max_element(out.begin(), out.end());
+    EXPECT_GT(top, 0.5f);
+    EXPECT_LT(top, 0.5f * 1.15f);
+
+    // And decays instead of holding an offset.
+    std::vector<float> later;
+    for (int i = 0; i < 4; i++)
+    {
+        later = frame();
+    }
+    EXPECT_LT(std::abs(later.back()), 0.01f);
+}
+
+TEST_F(BeeperTest, WritesWithoutChangeAddNothing)
+{
+    writeAt(100, 0x10);
+    writeAt(200, 0x17);
+    writeAt(300, 0x12);
+
+    BlepBuffer once{cyclesPerSample, Model48K::totalFrameCycles};
+    once.addStep(100, 0.5f, 0.5f);
+    once.endFrame();
+    std::vector<float> expected(4375);
+    once.read(expected.data(), 4375);
+
+    EXPECT_EQ(frame(), expected);
+}
+
+TEST_F(BeeperTest, StepAtTheTstateOfTheWrite)
+{
+    // An OUT ten tstates into an instruction starting at 90.
+    clock.advance(90);
+    beeper.setLevel(0x10, 10);
+
+    BlepBuffer once{cyclesPerSample, Model48K::totalFrameCycles};
+    once.addStep(100, 0.5f, 0.5f);
+    once.endFrame();
+    std::vector<float> expected(4375);
+    once.read(expected.data(), 4375);
+
+    EXPECT_EQ(frame(), expected);
+}
+
+TEST_F(BeeperTest, KeepsWhatDoesNotFit)
+{
+    writeAt(100, 0x10);
+    audio.endFrame();
+    clock.rebase(Model48K::totalFrameCycles);
+
+    EXPECT_EQ(audio.read(samples.data(), 100), 100);
+    EXPECT_EQ(audio.available(), 4275);
+    EXPECT_EQ(frame().size(), 4275 + 4375);
+}
+
+TEST_F(BeeperTest, QueueIsBounded)
+{
+    for (int i = 0; i < 20; i++)
+    {
+        writeAt(i * 100, (i & 1) << 4);
+        audio.endFrame();
+        clock.rebase(Model48K::totalFrameCycles);
+    }
+    EXPECT_EQ(audio.available(), audio.capacity());
+}
+
+TEST_F(BeeperTest, SquareWaveStaysBandLimited)
+{
+    // 1kHz: a level change every 1750 cycles.
+    for (int f = 0; f < 5; f++)
+    {
+        for (int cycles = 0; cycles < Model48K::totalFrameCycles; cycles += 1750)
+        {
+            writeAt(cycles, (cycles / 1750 & 1) << 4);
+        }
+        const auto out = frame();
+        ASSERT_EQ(out.size(), 4375);
+        // Settled around zero. Band-limited edges ring, but by a fraction
+        // of their height rather than the full swing aliasing would add.
+        if (f == 4)
+        {
+            const auto [low, high] = std::minmax_element(out.begin(), out.end());
+            EXPECT_GT(*high - *low, 0.5f);
+            EXPECT_LT(*high - *low, 0.5f * 1.3f);
+            EXPECT_NEAR(std::accumulate(out.begin(), out.end(), 0.0f) / out.size(), 0.0f, 0.05f);
+        }
+    }
+}
+
+TEST_F(Beeper128Test, FractionalSamplesCarry)
+{
+    // 70908 cycles is 4431.75 samples a frame.
+    std::size_t total = 0;
+    for (int i = 0; i < 10; i++)
+    {
+        const auto size = frame().size();
+        EXPECT_TRUE(size == 4431 || size == 4432) << size;
+        total += size;
+    }
+    EXPECT_EQ(total, 10 * Model128K::totalFrameCycles / cyclesPerSample);
+}
+
+TEST(BlepKernelTest, EveryPhaseSumsToOne)
+{
+    for (const auto& phase : BlepBuffer::kernel)
+    {
+        EXPECT_NEAR(std::accumulate(phase.begin(), phase.end(), 0.0f), 1.0f, 1e-5f);
+    }
+}
@@ -0,0 +1,94 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/Contention.hpp"
+
+#include <gtest/gtest.h>
+
+using Contention48 = Contention<Model48K>;
+using Screen48 = Screen<Model48K>;
+
+TEST(ContentionTest, NoDelayBeforeScreenFetch)
+{
+    for (int t = 0; t < Contention48::firstCycle; t++)
+    {
+        ASSERT_EQ(Contention48::memory(t), 0) << "tstate " << t;
+    }
+}
+
+TEST(ContentionTest, PatternAtLineStart)
+{
+    for (int line : {0, 1, 100, Screen48::screenHeight - 1})
+    {
+        const int start = Contention48::firstCycle + line * Screen48::totalLineCycles;
+        for (int i = 0; i < 16; i++)
+        {
+            EXPECT_EQ(Contention48::memory(start + i), Contention48::pattern[i % 8]);
+        }
+    }
+}
+
+TEST(ContentionTest, NoDelayInHorizontalBorder)
+{
+    const int lineStart = Contention48::firstCycle + 10 * Screen48::totalLineCycles;
+    for (int t = lineStart + Contention48::lineCycles; t < lineStart + Screen48::totalLineCycles; t++)
+    {
+        EXPECT_EQ(Contention48::memory(t), 0);
+    }
+}
+
+TEST(ContentionTest, NoDelayAfterLastLine)
+{
+    const int end = Contention48::firstCycle + Screen48::screenHeight * Screen48::totalLineCycles;
+    EXPECT_EQ(Contention48::memory(end), 0);
+    EXPECT_EQ(Contention48::memory(Screen48::totalFrameCycles - 1), 0);
+}
+
+TEST(ContentionTest, UncontendedOddPortNoDelay)
+{
+    EXPECT_EQ(Contention48::io(0x00FF, Contention48::firstCycle, false), 0);
+}
+
+TEST(ContentionTest, UlaPortContendedAfterFirstCycle)
+{
+    // N:1, C:3 - the second tstate of the access hits the pattern.
+    EXPECT_EQ(Contention48::io(0x00FE, Contention48::firstCycle - 1, false), 6);
+    EXPECT_EQ(Contention48::io(0x00FE, Contention48::firstCycle, false), 5);
+}
+
+TEST(ContentionTest, ContendedHighByteOddPort)
+{
+    // C:1, C:1, C:1, C:1 starting at the first contended tstate.
+    EXPECT_EQ(Contention48::io(0x40FF, Contention48::firstCycle, true), 6 + 0 + 6 + 0);
+}
+
+TEST(ContentionTest, Plus2APattern)
+{
+    using Plus2AContention = Contention<ModelPlus2A>;
+
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(Plus2AContention::memory(Plus2AContention::firstCycle + i), ModelPlus2A::contentionPattern[i]);
+    }
+}
+
+TEST(ContentionTest, Model128KLineLength)
+{
+    using Contention128K = Contention<Model128K>;
+
+    EXPECT_EQ(Contention128K::memory(Contention128K::firstCycle + Model128K::totalLineCycles), 6);
+    EXPECT_EQ(Contention128K::memory(Contention128K::firstCycle + Model48K::totalLineCycles), 0);
+}
@@ -0,0 +1,167 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/DirtyCells.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using Cells = DirtyCells<44, 36>;
+
+namespace
+{
+bool operator==(const DirtyRect& a, const DirtyRect& b)
+{
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+} // namespace
+
+class DirtyCellsTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        cells.endFrame(rects);
+    }
+
+    Cells cells;
+    std::vector<DirtyRect> rects;
+};
+
+TEST_F(DirtyCellsTest, StartsFullyDirty)
+{
+    Cells fresh;
+    fresh.endFrame(rects);
+
+    ASSERT_EQ(rects.size(), 1);
+    EXPECT_TRUE((rects[0] == DirtyRect{0, 0, 44 * 8, 36 * 8}));
+}
+
+TEST_F(DirtyCellsTest, RedrawIsNotAChange)
+{
+    cells.redraw();
+    EXPECT_TRUE(cells.dirty(43, 35));
+
+    cells.endFrame(rects);
+    EXPECT_TRUE(rects.empty());
+    EXPECT_FALSE(cells.dirty(43, 35));
+}
+
+TEST_F(DirtyCellsTest, CleanFrameHasNoRects)
+{
+    cells.endFrame(rects);
+
+    EXPECT_TRUE(rects.empty());
+    EXPECT_FALSE(cells.dirty(0, 0));
+}
+
+TEST_F(DirtyCellsTest, MarkLastsTwoFrames)
+{
+    cells.mark(3, 4);
+    EXPECT_TRUE(cells.dirty(3, 4));
+
+    cells.endFrame(rects);
+    ASSERT_EQ(rects.size(), 1);
+    EXPECT_TRUE((rects[0] == DirtyRect{24, 32, 8, 8}));
+    EXPECT_TRUE(cells.dirty(3, 4));
+
+    cells.endFrame(rects);
+    EXPECT_EQ(rects.size(), 1);
+
+    cells.endFrame(rects);
+    EXPECT_TRUE(rects.empty());
+}
+
+TEST_F(DirtyCellsTest, RunsMergeIntoColumns)
+{
+    for (int row = 2; row < 6; row++)
+    {
+        cells.markRow(row, 0b111100);
+    }
+    cells.mark(10, 3);
+    cells.mark(43, 35);
+
+    cells.endFrame(rects);
+
+    ASSERT_EQ(rects.size(), 3);
+    EXPECT_TRUE((rects[0] == DirtyRect{16, 16, 32, 32}));
+    EXPECT_TRUE((rects[1] == DirtyRect{80, 24, 8, 8}));
+    EXPECT_TRUE((rects[2] == DirtyRect{344, 280, 8, 8}));
+}
+
+TEST_F(DirtyCellsTest, DifferentWidthsStaySeparate)
+{
+    cells.markRow(0, 0b11);
+    cells.markRow(1, 0b1);
+
+    cells.endFrame(rects);
+
+    ASSERT_EQ(rects.size(), 2);
+    EXPECT_TRUE((rects[0] == DirtyRect{0, 0, 16, 8}));
+    EXPECT_TRUE((rects[1] == DirtyRect{0, 8, 8, 8}));
+}
+
+TEST(DirtyCellsRotationTest, ReturningBufferCatchesUp)
+{
+    DirtyCells<44, 36, 3> cells;
+    std::vector<DirtyRect> rects;
+
+    cells.endFrame(rects);
+    cells.drawInto(1);
+    cells.endFrame(rects);
+    cells.drawInto(2);
+    cells.endFrame(rects);
+    cells.drawInto(0);
+    EXPECT_TRUE(rects.empty());
+    EXPECT_FALSE(cells.dirty(0, 0));
+
+    cells.mark(5, 5);
+    cells.endFrame(rects);
+    cells.drawInto(1);
+    EXPECT_EQ(rects.size(), 1);
+    cells.endFrame(rects);
+    cells.drawInto(2);
+    EXPECT_EQ(rects.size(), 1);
+    EXPECT_TRUE(cells.dirty(5, 5));
+
+    // Buffer 0 may have drawn the cell before the change landed.
+    cells.endFrame(rects);
+    cells.drawInto(0);
+    EXPECT_TRUE(rects.empty());
+    EXPECT_TRUE(cells.dirty(5, 5));
+
+    cells.endFrame(rects);
+    cells.drawInto(1);
+    EXPECT_FALSE(cells.dirty(5, 5));
+    cells.endFrame(rects);
+    cells.drawInto(2);
+    EXPECT_FALSE(cells.dirty(5, 5));
+}
+
+TEST(WideDirtyCellsTest, RectsUseCellWidth)
+{
+    DirtyCells<44, 36, 1, 16> cells;
+    std::vector<DirtyRect> rects;
+    cells.endFrame(rects);
+    cells.endFrame(rects);
+
+    cells.mark(2, 1);
+    cells.mark(3, 1);
+    cells.endFrame(rects);
+
+    ASSERT_EQ(rects.size(), 1);
+    EXPECT_TRUE((rects[0] == DirtyRect{32, 8, 32, 8}));
+}
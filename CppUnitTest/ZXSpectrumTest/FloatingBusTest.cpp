@@ -0,0 +1,67 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/FloatingBus.hpp"
+
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+
+using FloatingBus48 = FloatingBus<Model48K>;
+using Screen48 = Screen<Model48K>;
+
+TEST(FloatingBusTest, IdleOutsidePaper)
+{
+    EXPECT_EQ(FloatingBus48::offset(0), FloatingBus48::idle);
+    EXPECT_EQ(FloatingBus48::offset(Screen48::cyclesToFirstByte - 1), FloatingBus48::idle);
+    EXPECT_EQ(FloatingBus48::offset(Screen48::cyclesToFirstByte + 128), FloatingBus48::idle);
+    const int end = Screen48::cyclesToFirstByte + 192 * Screen48::totalLineCycles;
+    EXPECT_EQ(FloatingBus48::offset(end), FloatingBus48::idle);
+}
+
+TEST(FloatingBusTest, FetchOrderWithinGroup)
+{
+    const int start = Screen48::cyclesToFirstByte + 8;
+
+    EXPECT_EQ(FloatingBus48::offset(start + 0), 2);
+    EXPECT_EQ(FloatingBus48::offset(start + 1), Screen48::attributeBase + 2);
+    EXPECT_EQ(FloatingBus48::offset(start + 2), 3);
+    EXPECT_EQ(FloatingBus48::offset(start + 3), Screen48::attributeBase + 3);
+    for (int i = 4; i < 8; i++)
+    {
+        EXPECT_EQ(FloatingBus48::offset(start + i), FloatingBus48::idle);
+    }
+}
+
+TEST(FloatingBusTest, LineToScreenAddress)
+{
+    const auto lineStart = [](int line) { return Screen48::cyclesToFirstByte + line * Screen48::totalLineCycles; };
+
+    EXPECT_EQ(FloatingBus48::offset(lineStart(1)), 0x0100);
+    EXPECT_EQ(FloatingBus48::offset(lineStart(8)), 0x0020);
+    EXPECT_EQ(FloatingBus48::offset(lineStart(8) + 1), Screen48::attributeBase + 32);
+    EXPECT_EQ(FloatingBus48::offset(lineStart(64)), 0x0800);
+    EXPECT_EQ(FloatingBus48::offset(lineStart(191) + 122), 0x17FF);
+}
+
+TEST(FloatingBusTest, ReadsScreenMemory)
+{
+    std::array<std::uint8_t, 0x1B00> vram{};
+    vram[Screen48::attributeBase] = 0x38;
+
+    EXPECT_EQ(FloatingBus48::read(vram.data(), Screen48::cyclesToFirstByte + 1), 0x38);
+    EXPECT_EQ(FloatingBus48::read(vram.data(), Screen48::cyclesToFirstByte + 4), 0xFF);
+}
@@ -0,0 +1,170 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/FrameBlender.hpp"
+#include "ZXSpectrum/PixelFormats.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+template <typename Format> class FrameBlenderTest : public ::testing::Test
+{
+  protected:
+    using Pixel = typename Format::Pixel;
+
+    static constexpr int width{24};
+    static constexpr int height{16};
+    static constexpr int stride{width + 4};
+    static constexpr DirtyRect sprite{.x = 8, .y = 8, .width = 8, .height = 8};
+
+    // Channel by channel: each one starts at a bit of lowBits and runs up
+    // to the next.
+    static Pixel referenceAverage(Pixel a, Pixel b)
+    {
+        Pixel result = 0;
+        Pixel bits = Format::lowBits;
+        while (bits != 0)
+        {
+            const int low = std::countr_zero(bits);
+            bits &= Pixel(bits - 1);
+            const int high = bits != 0 ? std::countr_zero(bits) : int(sizeof(Pixel) * 8);
+            const auto mask = std::uint64_t((std::uint64_t{1} << (high - low)) - 1);
+            const auto sum = ((a >> low) & mask) + ((b >> low) & mask);
+            result |= Pixel((sum / 2) << low);
+        }
+        return result;
+    }
+
+    std::vector<Pixel> frame(Pixel background, Pixel spriteColor) const
+    {
+        std::vector<Pixel> pixels(height * stride, background);
+        for (int y = sprite.y; y < sprite.y + sprite.height; y++)
+        {
+            std::fill_n(pixels.begin() + y * stride + sprite.x, sprite.width, spriteColor);
+        }
+        return pixels;
+    }
+
+    const Pixel* blend(const std::vector<Pixel>& pixels, std::span<const DirtyRect> changed)
+    {
+        return blender.blend(pixels.data(), stride, width, height, changed);
+    }
+
+    FrameBlender<Format> blender;
+};
+
+using Formats = ::testing::Types<Rgb555, Rgb565, Rgba8888, Bgra8888>;
+TYPED_TEST_SUITE(FrameBlenderTest, Formats);
+
+TYPED_TEST(FrameBlenderTest, AveragesEachChannel)
+{
+    using Pixel = typename TestFixture::Pixel;
+
+    for (int first = 0; first < 16; first++)
+    {
+        for (int second = 0; second < 16; second++)
+        {
+            std::array<Pixel, 19> a;
+            std::array<Pixel, 19> b;
+            a.fill(TypeParam::color(first & 7, first >= 8));
+            b.fill(TypeParam::color(second & 7, second >= 8));
+
+            std::array<Pixel, 19> out{};
+            FrameBlender<TypeParam>::average(a.data(), b.data(), out.data(), int(out.size()));
+
+            for (const Pixel pixel : out)
+            {
+                ASSERT_EQ(pixel, TestFixture::referenceAverage(a[0], b[0])) << first << " and " << second;
+            }
+        }
+    }
+}
+
+TYPED_TEST(FrameBlenderTest, FlickeringSpriteShowsAsMix)
+{
+    constexpr int width = TestFixture::width;
+    const auto black = TypeParam::color(0, false);
+    const auto white = TypeParam::color(7, true);
+    const std::array<DirtyRect, 1> spriteArea{TestFixture::sprite};
+
+    const auto without = this->frame(black, black);
+    const auto with = this->frame(black, white);
+
+    const auto* first = this->blend(without, {});
+    EXPECT_EQ(first[0], black);
+    EXPECT_EQ(this->blender.dirtyRects().size(), 1);
+
+    const auto* mixed = this->blend(with, spriteArea);
+    const auto mix = TestFixture::referenceAverage(black, white);
+    EXPECT_EQ(mixed[8 * width + 8], mix);
+    EXPECT_EQ(mixed[0], black);
+
+    mixed = this->blend(without, spriteArea);
+    EXPECT_EQ(mixed[8 * width + 8], mix);
+    EXPECT_EQ(this->blender.dirtyRects().size(), 2);
+
+    // Once the flicker stops the sprite settles a frame later.
+    const auto* settled = this->blend(without, {});
+    EXPECT_EQ(settled[8 * width + 8], black);
+    EXPECT_EQ(this->blender.dirtyRects().size(), 1);
+
+    this->blend(without, {});
+    EXPECT_TRUE(this->blender.dirtyRects().empty());
+}
+
+TYPED_TEST(FrameBlenderTest, ResetShowsNextFrameUnblended)
+{
+    constexpr int width = TestFixture::width;
+    const auto black = TypeParam::color(0, false);
+    const auto white = TypeParam::color(7, true);
+    const std::array<DirtyRect, 1> spriteArea{TestFixture::sprite};
+
+    this->blend(this->frame(black, black), {});
+    this->blender.reset();
+
+    const auto* out = this->blend(this->frame(black, white), spriteArea);
+    EXPECT_EQ(out[8 * width + 8], white);
+}
+
+TYPED_TEST(FrameBlenderTest, NoFrameGivesNoFrame)
+{
+    constexpr int width = TestFixture::width;
+    const auto black = TypeParam::color(0, false);
+    const auto white = TypeParam::color(7, true);
+    const std::array<DirtyRect, 1> spriteArea{TestFixture::sprite};
+
+    EXPECT_EQ(this->blender.blend(nullptr, TestFixture::stride, width, TestFixture::height, {}), nullptr);
+    EXPECT_TRUE(this->blender.dirtyRects().empty());
+
+    this->blend(this->frame(black, black), {});
+    EXPECT_EQ(this->blender.blend(nullptr, TestFixture::stride, width, TestFixture::height, spriteArea), nullptr);
+    EXPECT_TRUE(this->blender.dirtyRects().empty());
+
+    // The frame after a gap is shown whole, not mixed with the one before.
+    const auto* out = this->blend(this->frame(black, white), spriteArea);
+    EXPECT_EQ(out[8 * width + 8], white);
+    ASSERT_EQ(this->blender.dirtyRects().size(), 1);
+    EXPECT_EQ(this->blender.dirtyRects()[0].width, width);
+}
+
+TEST(FrameBlenderSupportTest, PaletteFormatsCannotBlend)
+{
+    EXPECT_TRUE(FrameBlender<Rgb555>::supported);
+    EXPECT_FALSE(FrameBlender<Indexed8>::supported);
+}
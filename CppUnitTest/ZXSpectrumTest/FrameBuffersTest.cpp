@@ -0,0 +1,109 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/FrameBuffers.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <thread>
+
+using Buffers = FrameBuffers<std::uint32_t, 16>;
+
+class FrameBuffersTest : public ::testing::Test
+{
+  protected:
+    void draw(std::uint32_t value)
+    {
+        std::fill_n(buffers.backBuffer(), 16, value);
+        buffers.publish();
+    }
+
+    Buffers buffers;
+};
+
+TEST_F(FrameBuffersTest, NothingToAcquireBeforePublish)
+{
+    EXPECT_EQ(buffers.acquire(), nullptr);
+}
+
+TEST_F(FrameBuffersTest, AcquireReturnsNewestFrame)
+{
+    draw(1);
+    draw(2);
+
+    const std::uint32_t* frame = buffers.acquire();
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame[0], 2);
+    EXPECT_EQ(frame, buffers.published());
+    EXPECT_EQ(buffers.acquire(), nullptr);
+}
+
+TEST_F(FrameBuffersTest, HeldFrameIsNeverDrawnInto)
+{
+    draw(1);
+    const std::uint32_t* held = buffers.acquire();
+
+    for (std::uint32_t i = 2; i < 10; i++)
+    {
+        EXPECT_NE(buffers.backBuffer(), held);
+        draw(i);
+    }
+    EXPECT_EQ(held[15], 1);
+
+    buffers.release();
+    const std::uint32_t* frame = buffers.acquire();
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame[0], 9);
+}
+
+TEST_F(FrameBuffersTest, BackBufferRotates)
+{
+    const std::uint32_t* first = buffers.backBuffer();
+    draw(1);
+    EXPECT_NE(buffers.backBuffer(), first);
+    EXPECT_EQ(buffers.published(), first);
+}
+
+TEST_F(FrameBuffersTest, ConsumerThreadNeverSeesTornFrame)
+{
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    std::thread consumer([&] {
+        while (!done.load())
+        {
+            if (const std::uint32_t* frame = buffers.acquire())
+            {
+                for (int i = 1; i < 16; i++)
+                {
+                    torn += frame[i] != frame[0];
+                }
+            }
+        }
+        buffers.release();
+    });
+
+    for (std::uint32_t i = 1; i < 20000; i++)
+    {
+        draw(i);
+    }
+    done = true;
+    consumer.join();
+
+    EXPECT_EQ(torn.load(), 0);
+}
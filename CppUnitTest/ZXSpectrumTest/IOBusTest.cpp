@@ -0,0 +1,77 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/IOBus.hpp"
+
+#include <gtest/gtest.h>
+
+using Screen48 = Screen<Model48K>;
+
+class IOBusTest : public ::testing::Test
+{
+  protected:
+    Scheduler clock;
+    Watchpoints watchpoints{clock};
+    Screen48 screen{clock};
+    Memory<Model48K> memory{clock, screen, watchpoints};
+    BlepBuffer audio{32, Model48K::totalFrameCycles};
+    Beeper beeper{clock, audio};
+    AyChip ay{clock, audio, Model48K::totalFrameCycles};
+    IOBus<Model48K> io{screen, screen, beeper, ay, memory, clock, watchpoints};
+};
+
+TEST_F(IOBusTest, FloatingBusAtTheTstateOfTheRead)
+{
+    memory.write(0x4000 + Screen48::attributeBase, 0x38, 0);
+
+    // An instruction starting three tstates before the ULA fetches the
+    // first attribute, whose port read comes three tstates in.
+    clock.advance(Screen48::cyclesToFirstByte + 1 - 3);
+    EXPECT_EQ(io.read(0x00FF, 0), 0xFF);
+    EXPECT_EQ(io.read(0x00FF, 3), 0x38);
+}
+
+TEST_F(IOBusTest, UlaPortContendedAtTheTstateOfTheAccess)
+{
+    clock.advance(Contention<Model48K>::firstCycle - 1 - 4);
+    io.read(0x00FE, 4);
+
+    EXPECT_EQ(clock.now(), Contention<Model48K>::firstCycle - 1 - 4 + 6);
+}
+
+TEST(IOBusPlus2ATest, PagingPortsDecodedApart)
+{
+    Scheduler clock;
+    Watchpoints watchpoints{clock};
+    Screen<ModelPlus2A> screen{clock};
+    Memory<ModelPlus2A> memory{clock, screen, watchpoints};
+    BlepBuffer audio{32, ModelPlus2A::totalFrameCycles};
+    Beeper beeper{clock, audio};
+    AyChip ay{clock, audio, ModelPlus2A::totalFrameCycles};
+    IOBus<ModelPlus2A> io{screen, screen, beeper, ay, memory, clock, watchpoints};
+
+    memory.write(0xC000, 0x5A, 0);
+
+    io.write(0x1FFD, Memory<ModelPlus2A>::plus3RomHigh, 0);
+    EXPECT_EQ(memory.read(0xC000, 0), 0x5A);
+
+    io.write(0x7FFD, 0x07, 0);
+    EXPECT_NE(memory.read(0xC000, 0), 0x5A);
+
+    io.write(0x1FFD, Memory<ModelPlus2A>::plus3Special, 0);
+    memory.write(0x0000, 0x33, 0);
+    EXPECT_EQ(memory.read(0x0000, 0), 0x33);
+}
@@ -0,0 +1,100 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/Machine.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+// Whole machines, each frame blended and scaled 2x so the steps after
+// rendering all run on whatever the renderer hands back.
+class MachineTest : public ::testing::TestWithParam<RenderMode>
+{
+  protected:
+    static constexpr std::uint16_t untouched{0x7C1F};
+
+    MachineTest()
+        : machine{MachineModel::ZX48K, PixelFormat::RGB555, GetParam()}, info{machine.frameInfo()},
+          scaled(std::size_t(info.width) * 2 * info.height * 2, untouched), data{}
+    {
+        data.blendFrames = true;
+        data.scaled = {.pixels = scaled.data(),
+                       .bytesPerRow = std::uint32_t(info.width * 2 * sizeof(std::uint16_t)),
+                       .factor = 2,
+                       .filter = ScaleFilter::Nearest};
+    }
+
+    // Every scaled pixel is a copy of the frame's.
+    void expectScaled() const
+    {
+        const auto* pixels = static_cast<const std::uint16_t*>(data.pixels);
+        for (int y = 0; y < info.height * 2; y++)
+        {
+            for (int x = 0; x < info.width * 2; x++)
+            {
+                ASSERT_EQ(scaled[std::size_t(y) * info.width * 2 + x], pixels[(y / 2) * info.width + x / 2])
+                    << x << "," << y;
+            }
+        }
+    }
+
+    Machine machine;
+    FrameInfo info;
+    std::vector<std::uint16_t> scaled;
+    FrameData data;
+};
+
+TEST_P(MachineTest, ScalesEveryFrameItHandsBack)
+{
+    for (int frame = 0; frame < 5; frame++)
+    {
+        machine.processFrame(data);
+        ASSERT_EQ(data.stopReason, StopReason::FrameComplete);
+        if (data.pixels == nullptr)
+        {
+            // Only the render thread's first call has nothing yet.
+            ASSERT_EQ(GetParam(), RenderMode::Threaded);
+            ASSERT_EQ(frame, 0);
+            EXPECT_EQ(data.dirtyRectCount, 0);
+            EXPECT_FALSE(data.unchanged);
+            EXPECT_EQ(scaled.front(), untouched);
+            continue;
+        }
+        expectScaled();
+    }
+    EXPECT_NE(data.pixels, nullptr);
+}
+
+INSTANTIATE_TEST_SUITE_P(RenderModes, MachineTest, ::testing::Values(RenderMode::Inline, RenderMode::Threaded));
+
+TEST(MachineModelTest, TC2048FramesAreDoubleWidth)
+{
+    Machine machine{MachineModel::TC2048};
+    const FrameInfo info = machine.frameInfo();
+    EXPECT_EQ(info.width, 704);
+    EXPECT_EQ(info.bytesPerRow, 704 * sizeof(std::uint16_t));
+
+    FrameData data{};
+    machine.processFrame(data);
+    ASSERT_EQ(data.stopReason, StopReason::FrameComplete);
+    ASSERT_NE(data.pixels, nullptr);
+    for (std::size_t i = 0; i < data.dirtyRectCount; i++)
+    {
+        EXPECT_LE(data.dirtyRects[i].x + data.dirtyRects[i].width, info.width);
+    }
+}
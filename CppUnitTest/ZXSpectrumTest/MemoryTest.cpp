@@ -0,0 +1,401 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "Mocks/ScreenCtrlMock.hpp"
+#include "ZXSpectrum/Memory.hpp"
+
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::SaveArg;
+
+using Memory48 = Memory<Model48K>;
+using Memory128 = Memory<Model128K>;
+
+class MemoryTest : public ::testing::Test
+{
+  protected:
+    Scheduler clock;
+    Watchpoints watchpoints{clock};
+    NiceMock<ScreenCtrlMock> screen;
+    Memory48 memory{clock, screen, watchpoints};
+};
+
+class Memory128Test : public ::testing::Test
+{
+  protected:
+    Scheduler clock;
+    Watchpoints watchpoints{clock};
+    NiceMock<ScreenCtrlMock> screen;
+    Memory128 memory{clock, screen, watchpoints};
+};
+
+TEST_F(MemoryTest, RomIsReadOnly)
+{
+    const std::array<std::uint8_t, 2> rom{0xF3, 0xAF};
+    memory.loadRom(rom);
+
+    memory.write(0x0000, 0x55, 0);
+
+    EXPECT_EQ(memory.read(0x0000, 0), 0xF3);
+    EXPECT_EQ(memory.read(0x0001, 0), 0xAF);
+}
+
+TEST_F(MemoryTest, RamReadsBackWrites)
+{
+    for (int addr : {0x4000, 0x7FFF, 0x8000, 0xC000, 0xFFFF})
+    {
+        memory.write(addr, addr >> 8, 0);
+        EXPECT_EQ(memory.read(addr, 0), addr >> 8);
+    }
+}
+
+TEST_F(MemoryTest, RamPagesAreDistinct)
+{
+    memory.write(0x4000, 0x40, 0);
+    memory.write(0x8000, 0x80, 0);
+    memory.write(0xC000, 0xC0, 0);
+
+    EXPECT_EQ(memory.read(0x4000, 0), 0x40);
+    EXPECT_EQ(memory.read(0x8000, 0), 0x80);
+    EXPECT_EQ(memory.read(0xC000, 0), 0xC0);
+    EXPECT_EQ(Memory48::ramBanks, 3);
+}
+
+TEST_F(MemoryTest, AddressWrapsAt64K)
+{
+    memory.write(0x18000, 0x42, 0);
+
+    EXPECT_EQ(memory.read(0x8000, 0), 0x42);
+}
+
+TEST_F(MemoryTest, ScreenMemoryIsAt4000)
+{
+    memory.write(0x4000, 0x12, 0);
+    memory.write(0x5AFF, 0x34, 0);
+
+    EXPECT_EQ(memory.screenMemory()[0], 0x12);
+    EXPECT_EQ(memory.screenMemory()[Memory48::screenSize - 1], 0x34);
+}
+
+TEST_F(MemoryTest, ContendedPageDelaysDuringScreenFetch)
+{
+    clock.advance(Contention<Model48K>::firstCycle);
+
+    memory.read(0x8000, 0);
+    EXPECT_EQ(clock.now(), Contention<Model48K>::firstCycle);
+
+    memory.read(0x4000, 0);
+    EXPECT_EQ(clock.now(), Contention<Model48K>::firstCycle + 6);
+}
+
+TEST_F(MemoryTest, ContentionAtTheAccessNotTheInstructionStart)
+{
+    // An instruction starting before the screen fetch whose read comes
+    // three tstates in.
+    clock.advance(Contention<Model48K>::firstCycle - 3);
+
+    memory.read(0x4000, 0);
+    EXPECT_EQ(clock.now(), Contention<Model48K>::firstCycle - 3);
+
+    memory.read(0x4000, 3);
+    EXPECT_EQ(clock.now(), Contention<Model48K>::firstCycle - 3 + 6);
+}
+
+TEST_F(MemoryTest, PagingIgnoredOn48K)
+{
+    memory.write(0xC000, 0x11, 0);
+
+    memory.setPaging(0x01, 0);
+
+    EXPECT_EQ(memory.read(0xC000, 0), 0x11);
+}
+
+TEST_F(Memory128Test, BankSwitchAtC000)
+{
+    memory.write(0xC000, 0x10, 0);
+    memory.setPaging(0x01, 0);
+    memory.write(0xC000, 0x11, 0);
+
+    EXPECT_EQ(memory.read(0xC000, 0), 0x11);
+    memory.setPaging(0x00, 0);
+    EXPECT_EQ(memory.read(0xC000, 0), 0x10);
+}
+
+TEST_F(Memory128Test, Bank5IsAlsoAt4000)
+{
+    memory.setPaging(0x05, 0);
+    memory.write(0xC123, 0x5A, 0);
+
+    EXPECT_EQ(memory.read(0x4123, 0), 0x5A);
+}
+
+TEST_F(Memory128Test, Bank2IsAlsoAt8000)
+{
+    memory.setPaging(0x02, 0);
+    memory.write(0x8123, 0x2A, 0);
+
+    EXPECT_EQ(memory.read(0xC123, 0), 0x2A);
+}
+
+TEST_F(Memory128Test, RomSelect)
+{
+    std::array<std::uint8_t, 2 * Memory48::romSize> roms{};
+    roms[0] = 0x00;
+    roms[Memory48::romSize] = 0x01;
+    memory.loadRom(roms);
+
+    EXPECT_EQ(memory.read(0x0000, 0), 0x00);
+    memory.setPaging(Memory48::pagingRom, 0);
+    EXPECT_EQ(memory.read(0x0000, 0), 0x01);
+}
+
+TEST_F(Memory128Test, ShadowScreenSelectsBank7)
+{
+    const std::uint8_t* screenMemory = nullptr;
+    EXPECT_CALL(screen, setScreenMemory(_, _)).WillOnce(SaveArg<0>(&screenMemory));
+
+    memory.setPaging(Memory48::pagingShadowScreen | 7, 0);
+    memory.write(0xC000, 0x77, 0);
+
+    ASSERT_EQ(screenMemory, memory.screenMemory());
+    EXPECT_EQ(screenMemory[0], 0x77);
+}
+
+TEST_F(Memory128Test, BankSwitchKeepingScreenLeavesItAlone)
+{
+    EXPECT_CALL(screen, setScreenMemory(_, _)).Times(0);
+
+    memory.setPaging(3, 0);
+    memory.setPaging(6, 0);
+}
+
+TEST_F(Memory128Test, LockIgnoresFurtherPaging)
+{
+    memory.setPaging(Memory48::pagingLock | 3, 0);
+    memory.write(0xC000, 0x33, 0);
+
+    memory.setPaging(0x00, 0);
+
+    EXPECT_EQ(memory.read(0xC000, 0), 0x33);
+}
+
+TEST_F(MemoryTest, PageMapFlagsPagesTheBusMustSee)
+{
+    const PageMap& pages = memory.pageMap();
+    memory.write(0x8000, 0x42, 0);
+
+    EXPECT_EQ(pages.readFlags[2], 0);
+    EXPECT_EQ(pages.writeFlags[2], 0);
+    EXPECT_EQ(pages.readPages[2][0], 0x42);
+    EXPECT_EQ(pages.writeFlags[0], 0);
+    EXPECT_NE(pages.readFlags[1], 0);
+    EXPECT_NE(pages.writeFlags[1], 0);
+
+    watchpoints.add(WatchRead, 0x8000, 0x8000);
+    memory.updateWatchpoints();
+    EXPECT_NE(pages.readFlags[2], 0);
+    EXPECT_EQ(pages.writeFlags[2], 0);
+}
+
+TEST_F(Memory128Test, PageMapFollowsPaging)
+{
+    const PageMap& pages = memory.pageMap();
+    memory.setPaging(0x03, 0);
+    pages.writePages[3][0x123] = 0x5A;
+
+    EXPECT_EQ(memory.read(0xC123, 0), 0x5A);
+    memory.setPaging(0x04, 0);
+    EXPECT_NE(pages.readPages[3][0x123], 0x5A);
+}
+
+TEST_F(Memory128Test, OddBanksContended)
+{
+    memory.setPaging(0x01, 0);
+    EXPECT_TRUE(memory.isContended(0xC000));
+
+    memory.setPaging(0x02, 0);
+    EXPECT_FALSE(memory.isContended(0xC000));
+    EXPECT_TRUE(memory.isContended(0x4000));
+    EXPECT_FALSE(memory.isContended(0x8000));
+}
+
+TEST_F(MemoryTest, ScreenWritesCatchUpDisplay)
+{
+    EXPECT_CALL(screen, beforeScreenWrite(0x0000, _));
+    EXPECT_CALL(screen, beforeScreenWrite(0x1AFF, _));
+
+    memory.write(0x4000, 0x01, 0);
+    memory.write(0x5AFF, 0x01, 0);
+    memory.write(0x5B00, 0x01, 0);
+    memory.read(0x4000, 0);
+    memory.write(0x8000, 0x01, 0);
+}
+
+TEST_F(MemoryTest, ScreenWriteCatchesUpToItsTstate)
+{
+    EXPECT_CALL(screen, beforeScreenWrite(0x0010, 5));
+
+    memory.write(0x4010, 0x01, 5);
+}
+
+TEST_F(Memory128Test, ShadowScreenMovesCatchUpToBank7)
+{
+    memory.setPaging(7, 0);
+    EXPECT_CALL(screen, beforeScreenWrite(0, _));
+    memory.write(0x4000, 0x01, 0);
+    memory.write(0xC000, 0x01, 0);
+    ::testing::Mock::VerifyAndClearExpectations(&screen);
+
+    memory.setPaging(Memory128::pagingShadowScreen | 7, 0);
+    EXPECT_CALL(screen, beforeScreenWrite(0, _));
+    memory.write(0x4000, 0x01, 0);
+    memory.write(0xC000, 0x01, 0);
+}
+
+TEST_F(MemoryTest, WriteWatchpointStopsAtHit)
+{
+    watchpoints.add(WatchWrite, 0x8000, 0x80FF);
+    memory.updateWatchpoints();
+
+    memory.write(0x7FFF, 0, 0);
+    memory.read(0x8000, 0);
+    EXPECT_FALSE(clock.due());
+
+    memory.write(0x8010, 0x42, 0);
+    ASSERT_TRUE(clock.due());
+    EXPECT_EQ(clock.pop(), Scheduler::Event::Break);
+    EXPECT_EQ(watchpoints.lastHit().kind, WatchWrite);
+    EXPECT_EQ(watchpoints.lastHit().address, 0x8010);
+    EXPECT_EQ(memory.read(0x8010, 0), 0x42);
+}
+
+TEST_F(MemoryTest, FetchWatchpointIgnoresReads)
+{
+    watchpoints.add(WatchExecute, 0x0038, 0x0038);
+    memory.updateWatchpoints();
+
+    memory.read(0x0038, 0);
+    EXPECT_FALSE(clock.due());
+
+    memory.fetch(0x0038, 0);
+    EXPECT_TRUE(clock.due());
+    EXPECT_EQ(watchpoints.lastHit().kind, WatchExecute);
+}
+
+TEST_F(MemoryTest, ClearedWatchpointsNoLongerTrap)
+{
+    watchpoints.add(WatchRead, 0xC000, 0xFFFF);
+    memory.updateWatchpoints();
+    watchpoints.clear();
+    memory.updateWatchpoints();
+
+    memory.read(0xC000, 0);
+
+    EXPECT_FALSE(clock.due());
+}
+
+TEST_F(Memory128Test, WatchpointFollowsAddressAcrossBanks)
+{
+    watchpoints.add(WatchRead, 0xC000, 0xC000);
+    memory.updateWatchpoints();
+
+    memory.setPaging(0x03, 0);
+    memory.read(0xC000, 0);
+
+    EXPECT_TRUE(clock.due());
+}
+
+class MemoryPlus2ATest : public ::testing::Test
+{
+  protected:
+    using MemoryPlus2A = Memory<ModelPlus2A>;
+
+    Scheduler clock;
+    Watchpoints watchpoints{clock};
+    NiceMock<ScreenCtrlMock> screen;
+    MemoryPlus2A memory{clock, screen, watchpoints};
+};
+
+TEST_F(MemoryPlus2ATest, HighBanksContended)
+{
+    EXPECT_TRUE(memory.isContended(0x4000));
+    memory.setPaging(0x03, 0);
+    EXPECT_FALSE(memory.isContended(0xC000));
+    memory.setPaging(0x04, 0);
+    EXPECT_TRUE(memory.isContended(0xC000));
+}
+
+TEST_F(MemoryPlus2ATest, FourRoms)
+{
+    std::array<std::uint8_t, 4 * MemoryPlus2A::romSize> roms{};
+    for (int i = 0; i < 4; i++)
+    {
+        roms[i * MemoryPlus2A::romSize] = std::uint8_t(i);
+    }
+    memory.loadRom(roms);
+
+    EXPECT_EQ(memory.read(0x0000, 0), 0);
+    memory.setPaging(MemoryPlus2A::pagingRom, 0);
+    EXPECT_EQ(memory.read(0x0000, 0), 1);
+    memory.setPlus3Paging(MemoryPlus2A::plus3RomHigh, 0);
+    EXPECT_EQ(memory.read(0x0000, 0), 3);
+    memory.setPaging(0, 0);
+    EXPECT_EQ(memory.read(0x0000, 0), 2);
+}
+
+TEST_F(MemoryPlus2ATest, SpecialPagingMapsAllRam)
+{
+    // Banks 4, 7, 6 and 3.
+    memory.setPlus3Paging(MemoryPlus2A::plus3Special | 3 << 1, 0);
+    memory.write(0x0000, 0x44, 0);
+    memory.write(0x4000, 0x77, 0);
+    EXPECT_EQ(memory.read(0x0000, 0), 0x44);
+    EXPECT_TRUE(memory.isContended(0x0000));
+
+    memory.setPlus3Paging(0, 0);
+    EXPECT_EQ(memory.read(0x0000, 0), 0x00);
+    memory.setPaging(7, 0);
+    EXPECT_EQ(memory.read(0xC000, 0), 0x77);
+    memory.setPaging(4, 0);
+    EXPECT_EQ(memory.read(0xC000, 0), 0x44);
+}
+
+TEST_F(MemoryPlus2ATest, LockCoversPlus3Port)
+{
+    memory.setPaging(MemoryPlus2A::pagingLock, 0);
+    memory.setPlus3Paging(MemoryPlus2A::plus3Special, 0);
+    memory.write(0x0000, 0x44, 0);
+
+    EXPECT_EQ(memory.read(0x0000, 0), 0x00);
+}
+
+TEST(MemoryPentagonTest, NothingContended)
+{
+    Scheduler clock;
+    Watchpoints watchpoints{clock};
+    NiceMock<ScreenCtrlMock> screen;
+    Memory<ModelPentagon> memory{clock, screen, watchpoints};
+
+    clock.advance(ModelPentagon::cyclesToFirstByte);
+    memory.read(0x4000, 0);
+
+    EXPECT_FALSE(memory.isContended(0x4000));
+    EXPECT_EQ(clock.now(), ModelPentagon::cyclesToFirstByte);
+}
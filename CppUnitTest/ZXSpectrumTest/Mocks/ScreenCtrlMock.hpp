@@ -15,10 +15,13 @@
 //
 #pragma once
 
-class IVSyncCtrl
+#include "Interfaces/IScreenCtrl.hpp"
+
+#include <gmock/gmock.h>
+
+class ScreenCtrlMock : public IScreenCtrl
 {
   public:
-    virtual ~IVSyncCtrl() = default;
-
-    virtual void vSync(int cycles) = 0;
+    MOCK_METHOD(void, setScreenMemory, (const std::uint8_t*, int), (final, override));
+    MOCK_METHOD(void, beforeScreenWrite, (int, int), (final, override));
 };
@@ -0,0 +1,130 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/OctetRenderer.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+
+template <typename Format> class OctetRendererTest : public ::testing::Test
+{
+  protected:
+    using Renderer = OctetRenderer<Format>;
+    using Pixel = typename Format::Pixel;
+
+    // Straightforward per-pixel version the tables must agree with.
+    static Pixel referencePixel(int attr, int bits, int bit, int flash)
+    {
+        int value = (bits >> (7 - bit)) & 1;
+        value ^= flash & (attr >> 7) & 1;
+
+        const int index = value ? (attr & 7) : ((attr >> 3) & 7);
+        return Format::color(index, (attr & 0x40) != 0);
+    }
+};
+
+using Formats = ::testing::Types<Rgb555, Rgb565, Rgba8888, Bgra8888, Indexed8>;
+TYPED_TEST_SUITE(OctetRendererTest, Formats);
+
+TYPED_TEST(OctetRendererTest, MatchesReferenceForAllAttributes)
+{
+    using Renderer = typename TestFixture::Renderer;
+    const std::array<int, 6> patterns{0x00, 0xFF, 0x80, 0x01, 0xA5, 0x3C};
+
+    for (int flash = 0; flash < 2; flash++)
+    {
+        for (int attr = 0; attr < 256; attr++)
+        {
+            for (const int bits : patterns)
+            {
+                std::array<typename TestFixture::Pixel, 8> out{};
+                Renderer::draw(out.data(), bits, Renderer::attributes[flash][attr]);
+
+                for (int i = 0; i < 8; i++)
+                {
+                    ASSERT_EQ(out[i], TestFixture::referencePixel(attr, bits, i, flash))
+                        << "flash " << flash << " attr " << attr << " bits " << bits << " pixel " << i;
+                }
+            }
+        }
+    }
+}
+
+TYPED_TEST(OctetRendererTest, MasksCoverEveryByte)
+{
+    using Renderer = typename TestFixture::Renderer;
+
+    for (int bits = 0; bits < 256; bits++)
+    {
+        int value = 0;
+        for (int i = 0; i < 8; i++)
+        {
+            value = (value << 1) | (Renderer::masks[bits][i] != 0);
+        }
+        ASSERT_EQ(value, bits);
+    }
+}
+
+TYPED_TEST(OctetRendererTest, FillWritesEightPixels)
+{
+    using Renderer = typename TestFixture::Renderer;
+
+    std::array<typename TestFixture::Pixel, 10> out{};
+    Renderer::fill(out.data() + 1, Renderer::borderColor(2));
+
+    EXPECT_EQ(out[0], 0);
+    for (int i = 1; i < 9; i++)
+    {
+        EXPECT_EQ(out[i], TypeParam::color(2, false));
+    }
+    EXPECT_EQ(out[9], 0);
+}
+
+TEST(PixelFormatsTest, Rgb555Levels)
+{
+    EXPECT_EQ(Rgb555::color(7, true), 0x7FFF);
+    EXPECT_EQ(Rgb555::color(7, false), 0x56B5);
+    EXPECT_EQ(Rgb555::color(1, true), 0x001F);
+    EXPECT_EQ(Rgb555::color(2, true), 0x7C00);
+    EXPECT_EQ(Rgb555::color(4, true), 0x03E0);
+}
+
+TEST(PixelFormatsTest, Rgb565GreenHasSixBits)
+{
+    EXPECT_EQ(Rgb565::color(4, true), 0x07E0);
+    EXPECT_EQ(Rgb565::color(7, true), 0xFFFF);
+}
+
+TEST(PixelFormatsTest, ByteOrderOf32BitFormats)
+{
+    std::array<std::uint8_t, 4> bytes;
+
+    const auto rgba = Rgba8888::color(2, true);
+    std::memcpy(bytes.data(), &rgba, sizeof(rgba));
+    EXPECT_EQ(bytes, (std::array<std::uint8_t, 4>{0xFF, 0x00, 0x00, 0xFF}));
+
+    const auto bgra = Bgra8888::color(1, false);
+    std::memcpy(bytes.data(), &bgra, sizeof(bgra));
+    EXPECT_EQ(bytes, (std::array<std::uint8_t, 4>{0xAD, 0x00, 0x00, 0xFF}));
+}
+
+TEST(PixelFormatsTest, IndexedAddsEightForBright)
+{
+    EXPECT_EQ(Indexed8::color(5, false), 5);
+    EXPECT_EQ(Indexed8::color(5, true), 13);
+}
@@ -0,0 +1,133 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/Models.hpp"
+#include "ZXSpectrum/RenderThread.hpp"
+#include "ZXSpectrum/Screen.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+
+using Screen48 = Screen<Model48K>;
+
+namespace
+{
+constexpr int frameSize{Screen48::frameWidth * Screen48::frameHeight};
+
+// Feeds the same frame of activity to a screen or anything standing in
+// for one.
+template <typename Ctrl> void playFrame(Scheduler& clock, Ctrl& ctrl, std::array<std::uint8_t, 0x1B00>& vram, int seed)
+{
+    for (int i = 0; i < 400; i++)
+    {
+        const int offset = (seed * 131 + i * 977) % 0x1B00;
+        clock.advance(150);
+        ctrl.beforeScreenWrite(offset, 0);
+        vram[offset] = static_cast<std::uint8_t>(seed + i * 7);
+
+        if (i % 50 == 0)
+        {
+            ctrl.setBorder(seed + i, 0);
+        }
+
+        if (i == 200)
+        {
+            ctrl.setPaletteEntry(seed * 5 % 64, seed * 37, 0);
+            ctrl.setPaletteEnabled((seed & 1) != 0, 0);
+        }
+    }
+    clock.advance(Screen48::totalFrameCycles - clock.now() + 3);
+}
+} // namespace
+
+class RenderThreadTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        inlineScreen.setScreenMemory(inlineVram.data(), 0);
+        renderThread->setScreenMemory(threadedVram.data(), 0);
+    }
+
+    // The worker must stop before the screen it draws into goes away.
+    ~RenderThreadTest() override
+    {
+        renderThread.reset();
+    }
+
+    Scheduler inlineClock;
+    Screen48 inlineScreen{inlineClock};
+    std::array<std::uint8_t, 0x1B00> inlineVram{};
+
+    Scheduler threadedClock;
+    std::array<std::uint8_t, 0x1B00> threadedVram{};
+    std::unique_ptr<RenderThread<Screen48>> renderThread{
+        std::make_unique<RenderThread<Screen48>>(threadedClock, threadedScreen)};
+    Screen48 threadedScreen{renderThread->replayClock()};
+};
+
+TEST_F(RenderThreadTest, NoFrameBeforeFirstHandoff)
+{
+    EXPECT_EQ(renderThread->pixels(), nullptr);
+}
+
+TEST_F(RenderThreadTest, ReplayMatchesInlineRendering)
+{
+    std::array<std::array<Screen48::Pixel, frameSize>, 4> expected;
+
+    for (int frame = 0; frame < 5; frame++)
+    {
+        if (frame < 4)
+        {
+            playFrame(inlineClock, inlineScreen, inlineVram, frame);
+            inlineScreen.catchUp();
+            inlineClock.rebase(Screen48::totalFrameCycles);
+            inlineScreen.newFrame(inlineClock.now());
+            std::copy_n(inlineScreen.publishedPixels(), frameSize, expected[frame].begin());
+
+            playFrame(threadedClock, *renderThread, threadedVram, frame);
+        }
+        else
+        {
+            threadedClock.advance(Screen48::totalFrameCycles - threadedClock.now());
+        }
+
+        renderThread->endFrame();
+        threadedClock.rebase(Screen48::totalFrameCycles);
+
+        if (frame > 0)
+        {
+            ASSERT_NE(renderThread->pixels(), nullptr);
+            EXPECT_TRUE(std::equal(expected[frame - 1].begin(), expected[frame - 1].end(), renderThread->pixels()))
+                << "frame " << frame - 1;
+        }
+    }
+}
+
+TEST_F(RenderThreadTest, IdleFrameReportsNoChanges)
+{
+    for (int frame = 0; frame < 5; frame++)
+    {
+        threadedClock.advance(Screen48::totalFrameCycles - threadedClock.now());
+        renderThread->endFrame();
+        threadedClock.rebase(Screen48::totalFrameCycles);
+    }
+
+    EXPECT_TRUE(renderThread->dirtyRects().empty());
+}
@@ -0,0 +1,170 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/Resampler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <numbers>
+#include <vector>
+
+class ResamplerTest : public ::testing::Test
+{
+  protected:
+    // One sample every 16 cycles of a 3.5MHz 48K.
+    static constexpr double inputRate{3500000.0 / 16};
+    static constexpr int outputRate{44100};
+    static constexpr int frameInput{4375};
+
+    // Frames of interleaved sine, left at frequency, right silent.
+    std::vector<float> sine(double frequency, int frames)
+    {
+        std::vector<float> samples(2 * frames);
+        for (int i = 0; i < frames; i++)
+        {
+            samples[2 * i] = float(std::sin(2 * std::numbers::pi * frequency * double(phase++) / inputRate));
+        }
+        return samples;
+    }
+
+    // Stereo output of feeding count frames of the sine.
+    std::vector<float> run(double frequency, int frames)
+    {
+        std::vector<float> out;
+        for (int f = 0; f < frames; f++)
+        {
+            const auto in = sine(frequency, frameInput);
+            resampler.push(in.data(), frameInput);
+            std::vector<float> chunk(2 * 2048);
+            const auto count = resampler.pull(chunk.data(), 2048, true);
+            out.insert(out.end(), chunk.begin(), chunk.begin() + 2 * count);
+        }
+        return out;
+    }
+
+    // Peak of one side, skipping the start while the filter fills.
+    static float peak(const std::vector<float>& out, int side)
+    {
+        float result = 0.0f;
+        for (std::size_t i = 2 * 1000 + side; i < out.size(); i += 2)
+        {
+            result = std::max(result, std::abs(out[i]));
+        }
+        return result;
+    }
+
+    Resampler resampler;
+    long phase{0};
+};
+
+TEST_F(ResamplerTest, PassesAudibleTonesUnchanged)
+{
+    resampler.setRatio(inputRate / outputRate);
+    const auto out = run(1000.0, 10);
+
+    EXPECT_NEAR(peak(out, 0), 1.0f, 0.01f);
+    EXPECT_EQ(peak(out, 1), 0.0f);
+
+    // 1kHz at 44.1kHz: a rising zero crossing every 44.1 samples.
+    int crossings = 0;
+    for (std::size_t i = 2 * 1001; i < out.size(); i += 2)
+    {
+        crossings += out[i - 2] < 0.0f && out[i] >= 0.0f;
+    }
+    const double seconds = double(out.size() / 2 - 1000) / outputRate;
+    EXPECT_NEAR(crossings, seconds * 1000.0, 2.0);
+}
+
+TEST_F(ResamplerTest, RemovesWhatWouldAlias)
+{
+    // 30kHz would fold down to 14.1kHz.
+    resampler.setRatio(inputRate / outputRate);
+    EXPECT_LT(peak(run(30000.0, 10), 0), 0.01f);
+}
+
+TEST_F(ResamplerTest, OutputFollowsTheRatio)
+{
+    resampler.setRatio(inputRate / outputRate);
+    const auto first = run(440.0, 50).size() / 2;
+    // 4375 frames of 218.75kHz are exactly 882 at 44.1kHz, less the
+    // filter's latency.
+    EXPECT_NEAR(double(first), 50 * 882.0, 40.0);
+
+    // A fraction of a percent faster output, as rate control would ask.
+    resampler.setRatio(inputRate / outputRate * 0.995);
+    const auto second = run(440.0, 50).size() / 2;
+    EXPECT_NEAR(double(second), 50 * 882.0 / 0.995, 2.0);
+}
+
+TEST_F(ResamplerTest, KeepsInputItCouldNotUse)
+{
+    resampler.setRatio(inputRate / outputRate);
+    run(440.0, 2);
+
+    const auto in = sine(440.0, frameInput);
+    resampler.push(in.data(), frameInput);
+    std::vector<float> out(2048);
+    EXPECT_EQ(resampler.pull(out.data(), 100, false), 100);
+    const auto rest = resampler.pull(out.data(), 2048, false);
+    EXPECT_NEAR(double(rest), 782.0, 1.0);
+}
+
+TEST_F(ResamplerTest, MonoMixesBothSides)
+{
+    resampler.setRatio(2.0);
+    std::vector<float> in(2 * 400);
+    for (std::size_t i = 0; i < in.size(); i += 2)
+    {
+        in[i] = 1.0f;
+        in[i + 1] = 0.5f;
+    }
+    resampler.push(in.data(), 400);
+    std::vector<float> out(200);
+    const auto count = resampler.pull(out.data(), 200, false);
+
+    ASSERT_GT(count, 100);
+    EXPECT_NEAR(out[count - 1], 0.75f, 1e-4f);
+}
+
+TEST(ResamplerDotTest, MatchesPlainSum)
+{
+    std::vector<float> in(64);
+    std::vector<float> first(64);
+    std::vector<float> second(64);
+    for (int i = 0; i < 64; i++)
+    {
+        in[i] = float(i % 7) - 3.0f;
+        first[i] = float(i / 2) * 0.25f;
+        second[i] = float(i % 5) * -0.5f;
+    }
+    std::array<float, 4> expected{};
+    for (int i = 0; i < 64; i += 2)
+    {
+        expected[0] += in[i] * first[i];
+        expected[1] += in[i + 1] * first[i + 1];
+        expected[2] += in[i] * second[i];
+        expected[3] += in[i + 1] * second[i + 1];
+    }
+
+    const auto sums = Resampler::dot(in.data(), first.data(), second.data(), 64);
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_FLOAT_EQ(sums[i], expected[i]) << i;
+    }
+}
@@ -0,0 +1,67 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/RomImage.hpp"
+
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(RomImageTest, SameContentShared)
+{
+    const std::array<std::uint8_t, 3> content{0xF3, 0xAF, 0x11};
+
+    const auto first = RomImage::intern(content);
+    const auto second = RomImage::intern(content);
+
+    EXPECT_EQ(first, second);
+}
+
+TEST(RomImageTest, DifferentContentNotShared)
+{
+    const std::array<std::uint8_t, 3> content1{0xF3, 0xAF, 0x11};
+    const std::array<std::uint8_t, 3> content2{0xF3, 0xAF, 0x12};
+    const std::array<std::uint8_t, 2> content3{0xF3, 0xAF};
+
+    const auto first = RomImage::intern(content1);
+
+    EXPECT_NE(first, RomImage::intern(content2));
+    EXPECT_NE(first, RomImage::intern(content3));
+}
+
+TEST(RomImageTest, ContentSplitIntoPages)
+{
+    std::vector<std::uint8_t> content(RomImage::pageSize + 1, 0x11);
+    content.back() = 0x22;
+
+    const auto image = RomImage::intern(content);
+
+    EXPECT_EQ(image->page(0)[0], 0x11);
+    EXPECT_EQ(image->page(1)[0], 0x22);
+    EXPECT_EQ(image->page(1)[1], 0x00);
+}
+
+TEST(RomImageTest, ReleasedImageRecreated)
+{
+    const std::array<std::uint8_t, 1> content{0x5A};
+
+    RomImage::intern(content);
+    const auto image = RomImage::intern(content);
+
+    EXPECT_EQ(image.use_count(), 1);
+    EXPECT_EQ(image->page(0)[0], 0x5A);
+}
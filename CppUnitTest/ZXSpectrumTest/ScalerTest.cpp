@@ -0,0 +1,180 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/Scaler.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+template <typename Pixel> class ScalerTest : public ::testing::Test
+{
+  protected:
+    // Odd width so the vector loops leave a tail; few colours so the edge
+    // rules see plenty of equal neighbours.
+    static constexpr int width{37};
+    static constexpr int height{11};
+    static constexpr int padding{5};
+
+    void SetUp() override
+    {
+        source.resize(height * stride);
+        std::uint32_t seed = 12345;
+        for (auto& pixel : source)
+        {
+            seed = seed * 1103515245 + 12345;
+            pixel = Pixel((seed >> 16) % 3) * Pixel(0x0101);
+        }
+    }
+
+    Pixel at(int x, int y) const
+    {
+        return source[std::clamp(y, 0, height - 1) * stride + std::clamp(x, 0, width - 1)];
+    }
+
+    // Straightforward Scale2x the scaler must agree with.
+    std::vector<Pixel> reference2x() const
+    {
+        std::vector<Pixel> out(width * 2 * height * 2);
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                const Pixel b = at(x, y - 1), d = at(x - 1, y), e = at(x, y), f = at(x + 1, y), h = at(x, y + 1);
+                Pixel* row0 = &out[(2 * y) * width * 2 + 2 * x];
+                Pixel* row1 = row0 + width * 2;
+                const bool edge = b != h && d != f;
+                row0[0] = edge && d == b ? d : e;
+                row0[1] = edge && b == f ? f : e;
+                row1[0] = edge && d == h ? d : e;
+                row1[1] = edge && h == f ? f : e;
+            }
+        }
+        return out;
+    }
+
+    std::vector<Pixel> scaled(int factor, ScaleFilter filter, int outStride)
+    {
+        std::vector<Pixel> out(height * factor * outStride, Pixel(0x7F));
+        scaler.scale(source.data(), stride, width, height, out.data(), outStride, factor, filter);
+        return out;
+    }
+
+    static constexpr int stride{width + padding};
+
+    Scaler<Pixel> scaler;
+    std::vector<Pixel> source;
+};
+
+using Pixels = ::testing::Types<std::uint8_t, std::uint16_t, std::uint32_t>;
+TYPED_TEST_SUITE(ScalerTest, Pixels);
+
+TYPED_TEST(ScalerTest, NearestRepeatsPixels)
+{
+    constexpr int width = TestFixture::width;
+    constexpr int height = TestFixture::height;
+
+    for (int factor = 2; factor <= 4; factor++)
+    {
+        const int outStride = width * factor + 3;
+        const auto out = this->scaled(factor, ScaleFilter::Nearest, outStride);
+
+        for (int y = 0; y < height * factor; y++)
+        {
+            for (int x = 0; x < width * factor; x++)
+            {
+                ASSERT_EQ(out[y * outStride + x], this->at(x / factor, y / factor))
+                    << "factor " << factor << " at " << x << "," << y;
+            }
+            ASSERT_EQ(out[y * outStride + width * factor], TypeParam(0x7F));
+        }
+    }
+}
+
+TYPED_TEST(ScalerTest, Scale2xMatchesReference)
+{
+    constexpr int outWidth = TestFixture::width * 2;
+    const auto expected = this->reference2x();
+    const auto out = this->scaled(2, ScaleFilter::Smooth, outWidth);
+
+    EXPECT_EQ(out, expected);
+}
+
+TYPED_TEST(ScalerTest, Scale4xIsScale2xTwice)
+{
+    constexpr int width = TestFixture::width;
+    constexpr int height = TestFixture::height;
+
+    const auto once = this->reference2x();
+    std::vector<TypeParam> expected(width * 4 * height * 4);
+    this->scaler.scale(once.data(), width * 2, width * 2, height * 2, expected.data(), width * 4, 2,
+                       ScaleFilter::Smooth);
+
+    EXPECT_EQ(this->scaled(4, ScaleFilter::Smooth, width * 4), expected);
+}
+
+TYPED_TEST(ScalerTest, Scale3xKeepsCentreAndFlatAreas)
+{
+    constexpr int width = TestFixture::width;
+    constexpr int height = TestFixture::height;
+    const auto out = this->scaled(3, ScaleFilter::Smooth, width * 3);
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            ASSERT_EQ(out[(3 * y + 1) * width * 3 + 3 * x + 1], this->at(x, y));
+        }
+    }
+
+    std::fill(this->source.begin(), this->source.end(), TypeParam(2));
+    const auto flat = this->scaled(3, ScaleFilter::Smooth, width * 3);
+    EXPECT_TRUE(std::all_of(flat.begin(), flat.end(), [](TypeParam pixel) { return pixel == TypeParam(2); }));
+}
+
+TYPED_TEST(ScalerTest, NothingToScaleLeavesDestination)
+{
+    constexpr int width = TestFixture::width;
+    constexpr int height = TestFixture::height;
+    std::vector<TypeParam> out(width * 2 * height * 2, TypeParam(0x7F));
+
+    for (const auto filter : {ScaleFilter::Nearest, ScaleFilter::Smooth})
+    {
+        for (int factor = 2; factor <= 4; factor++)
+        {
+            this->scaler.scale(nullptr, width, width, height, out.data(), width * 2, factor, filter);
+        }
+    }
+    this->scaler.scale(this->source.data(), TestFixture::stride, width, height, nullptr, width * 2, 2,
+                       ScaleFilter::Nearest);
+
+    EXPECT_TRUE(std::all_of(out.begin(), out.end(), [](TypeParam pixel) { return pixel == TypeParam(0x7F); }));
+}
+
+TEST(ScalerEdgeTest, Scale3xRoundsDiagonal)
+{
+    // A dark pixel closing a diagonal step, the textbook Scale3x case.
+    const std::vector<std::uint8_t> source{1, 1, 0, 1, 0, 0, 0, 0, 0};
+    std::vector<std::uint8_t> out(81);
+    Scaler<std::uint8_t> scaler;
+    scaler.scale(source.data(), 3, 3, 3, out.data(), 9, 3, ScaleFilter::Smooth);
+
+    // Centre pixel E = 0 with B = 1 and D = 1: the top-left corner takes 1.
+    EXPECT_EQ(out[3 * 9 + 3], 1);
+    EXPECT_EQ(out[4 * 9 + 4], 0);
+    EXPECT_EQ(out[5 * 9 + 5], 0);
+}
@@ -0,0 +1,96 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/Scheduler.hpp"
+
+#include <gtest/gtest.h>
+
+using Event = Scheduler::Event;
+
+TEST(SchedulerTest, NothingScheduledNeverDue)
+{
+    Scheduler scheduler;
+
+    scheduler.advance(1000000);
+
+    EXPECT_FALSE(scheduler.due());
+    EXPECT_EQ(scheduler.deadline(), Scheduler::never);
+}
+
+TEST(SchedulerTest, DueAtDeadline)
+{
+    Scheduler scheduler;
+    scheduler.schedule(Event::FrameEnd, 100);
+
+    scheduler.advance(99);
+    EXPECT_FALSE(scheduler.due());
+
+    scheduler.advance(1);
+    EXPECT_TRUE(scheduler.due());
+    EXPECT_EQ(scheduler.pop(), Event::FrameEnd);
+    EXPECT_FALSE(scheduler.pending(Event::FrameEnd));
+}
+
+TEST(SchedulerTest, PopsInDeadlineOrder)
+{
+    Scheduler scheduler;
+    scheduler.schedule(Event::FrameEnd, 100);
+    scheduler.schedule(Event::IntEnd, 32);
+
+    EXPECT_EQ(scheduler.deadline(), 32);
+    EXPECT_EQ(scheduler.pop(), Event::IntEnd);
+    EXPECT_EQ(scheduler.deadline(), 100);
+    EXPECT_EQ(scheduler.pop(), Event::FrameEnd);
+    EXPECT_EQ(scheduler.deadline(), Scheduler::never);
+}
+
+TEST(SchedulerTest, RescheduleMovesDeadlineLater)
+{
+    Scheduler scheduler;
+    scheduler.schedule(Event::FrameEnd, 100);
+    scheduler.schedule(Event::IntEnd, 32);
+
+    scheduler.schedule(Event::IntEnd, 200);
+
+    EXPECT_EQ(scheduler.deadline(), 100);
+    EXPECT_EQ(scheduler.pop(), Event::FrameEnd);
+}
+
+TEST(SchedulerTest, CancelRemovesEvent)
+{
+    Scheduler scheduler;
+    scheduler.schedule(Event::IntEnd, 32);
+
+    scheduler.cancel(Event::IntEnd);
+
+    EXPECT_FALSE(scheduler.pending(Event::IntEnd));
+    EXPECT_EQ(scheduler.deadline(), Scheduler::never);
+}
+
+TEST(SchedulerTest, RebaseShiftsClockAndEvents)
+{
+    Scheduler scheduler;
+    scheduler.schedule(Event::FrameEnd, 70000);
+    scheduler.schedule(Event::IntEnd, 70032);
+    scheduler.advance(70003);
+
+    scheduler.rebase(70000);
+
+    EXPECT_EQ(scheduler.now(), 3);
+    EXPECT_EQ(scheduler.deadline(), 0);
+    EXPECT_EQ(scheduler.pop(), Event::FrameEnd);
+    EXPECT_EQ(scheduler.deadline(), 32);
+}
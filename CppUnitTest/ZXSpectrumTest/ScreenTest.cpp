@@ -0,0 +1,518 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "ZXSpectrum/Models.hpp"
+#include "ZXSpectrum/Screen.hpp"
+
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+using Screen48 = Screen<Model48K>;
+
+class ScreenTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        screen.setScreenMemory(vram.data(), 0);
+    }
+
+    Screen48::Pixel pixel(int x, int y)
+    {
+        return screen.pixels()[y * Screen48::frameWidth + x];
+    }
+
+    Screen48::Pixel shown(int x, int y)
+    {
+        return screen.publishedPixels()[y * Screen48::frameWidth + x];
+    }
+
+    void finishFrame()
+    {
+        clock.advance(Screen48::totalFrameCycles - clock.now());
+        screen.catchUp();
+        clock.rebase(Screen48::totalFrameCycles);
+        screen.newFrame(clock.now());
+    }
+
+    Scheduler clock;
+    Screen48 screen{clock};
+    std::array<std::uint8_t, 0x1B00> vram{};
+};
+
+TEST_F(ScreenTest, NothingDrawnUntilCaughtUp)
+{
+    vram[0] = 0xFF;
+    vram[Screen48::attributeBase] = 0x07;
+
+    clock.advance(Screen48::totalFrameCycles);
+    EXPECT_EQ(pixel(Screen48::borderWidth, Screen48::borderHeight), 0);
+
+    screen.catchUp();
+    EXPECT_EQ(pixel(Screen48::borderWidth, Screen48::borderHeight), Screen48::Renderer::borderColor(7));
+}
+
+TEST_F(ScreenTest, BorderComposedAtFrameEnd)
+{
+    clock.advance(Screen48::totalFrameCycles);
+    screen.catchUp();
+    EXPECT_EQ(pixel(0, 0), 0);
+
+    finishFrame();
+    EXPECT_EQ(shown(0, 0), Screen48::Renderer::borderColor(7));
+    EXPECT_EQ(shown(Screen48::frameWidth - 1, Screen48::frameHeight - 1), Screen48::Renderer::borderColor(7));
+}
+
+TEST_F(ScreenTest, BorderChangeSplitsLineAtBeam)
+{
+    clock.advance(Screen48::topLeftCornerCycles + 10 * Screen48::octetCycles);
+    screen.setBorder(2, 0);
+    finishFrame();
+
+    EXPECT_EQ(shown(79, 0), Screen48::Renderer::borderColor(7));
+    EXPECT_EQ(shown(80, 0), Screen48::Renderer::borderColor(2));
+    EXPECT_EQ(shown(Screen48::frameWidth - 1, 0), Screen48::Renderer::borderColor(2));
+    EXPECT_EQ(shown(0, 1), Screen48::Renderer::borderColor(2));
+}
+
+TEST_F(ScreenTest, BorderChangeAtTheTstateOfTheWrite)
+{
+    // An OUT whose write lands two octets into the instruction.
+    clock.advance(Screen48::topLeftCornerCycles + 8 * Screen48::octetCycles);
+    screen.setBorder(2, 2 * Screen48::octetCycles);
+    finishFrame();
+
+    EXPECT_EQ(shown(79, 0), Screen48::Renderer::borderColor(7));
+    EXPECT_EQ(shown(80, 0), Screen48::Renderer::borderColor(2));
+}
+
+TEST_F(ScreenTest, BorderChangeMidOctetTakesWholeOctet)
+{
+    const int paperLine = Screen48::borderHeight + 5;
+    const int lineStart = Screen48::topLeftCornerCycles + paperLine * Screen48::totalLineCycles;
+
+    clock.advance(lineStart + 3 * Screen48::octetCycles + 3);
+    screen.setBorder(4, 0);
+    clock.advance(Screen48::totalLineCycles - 2);
+    screen.setBorder(5, 0);
+    finishFrame();
+
+    EXPECT_EQ(shown(23, paperLine), Screen48::Renderer::borderColor(7));
+    EXPECT_EQ(shown(24, paperLine), Screen48::Renderer::borderColor(4));
+    EXPECT_EQ(shown(Screen48::frameWidth - 1, paperLine), Screen48::Renderer::borderColor(4));
+    EXPECT_EQ(shown(16, paperLine + 1), Screen48::Renderer::borderColor(4));
+    EXPECT_EQ(shown(24, paperLine + 1), Screen48::Renderer::borderColor(5));
+}
+
+TEST_F(ScreenTest, StripesOnEveryLine)
+{
+    for (int line = 0; line < Screen48::frameHeight; line++)
+    {
+        clock.advance(Screen48::topLeftCornerCycles + line * Screen48::totalLineCycles - clock.now());
+        screen.setBorder(line & 7, 0);
+    }
+    finishFrame();
+
+    for (int line = 1; line < Screen48::frameHeight; line++)
+    {
+        ASSERT_EQ(shown(0, line), Screen48::Renderer::borderColor(line & 7)) << "line " << line;
+        ASSERT_EQ(shown(Screen48::frameWidth - 1, line), Screen48::Renderer::borderColor(line & 7)) << "line " << line;
+    }
+}
+
+TEST_F(ScreenTest, AttributeWriteBetweenLines)
+{
+    vram[0x000] = 0xFF;
+    vram[0x100] = 0xFF;
+
+    clock.advance(Screen48::cyclesToFirstByte + Screen48::totalLineCycles - 8);
+    screen.catchUp();
+    vram[Screen48::attributeBase] = 0x07;
+    clock.advance(Screen48::totalLineCycles);
+    screen.catchUp();
+
+    EXPECT_EQ(pixel(Screen48::borderWidth, Screen48::borderHeight), 0);
+    EXPECT_EQ(pixel(Screen48::borderWidth, Screen48::borderHeight + 1), Screen48::Renderer::borderColor(7));
+}
+
+TEST_F(ScreenTest, AttributeWriteLateInInstructionMissesNextLine)
+{
+    vram[0x000] = 0xFF;
+    vram[0x100] = 0xFF;
+    vram[0x200] = 0xFF;
+
+    // The same instruction as above, but its write lands after the beam
+    // has fetched the attribute for the second line.
+    clock.advance(Screen48::cyclesToFirstByte + Screen48::totalLineCycles - 8);
+    screen.beforeScreenWrite(Screen48::attributeBase, 16);
+    vram[Screen48::attributeBase] = 0x07;
+    clock.advance(2 * Screen48::totalLineCycles);
+    screen.catchUp();
+
+    EXPECT_EQ(pixel(Screen48::borderWidth, Screen48::borderHeight + 1), 0);
+    EXPECT_EQ(pixel(Screen48::borderWidth, Screen48::borderHeight + 2), Screen48::Renderer::borderColor(7));
+}
+
+TEST_F(ScreenTest, BankSwitchLateInInstructionMissesNextLine)
+{
+    std::array<std::uint8_t, 0x1B00> shadow{};
+    vram[0x100] = 0xFF;
+    vram[0x200] = 0xFF;
+    vram[Screen48::attributeBase] = 0x07;
+    shadow = vram;
+    shadow[Screen48::attributeBase] = 0x00;
+
+    // An OUT that flips to a screen with black ink once the beam has
+    // fetched the second line.
+    clock.advance(Screen48::cyclesToFirstByte + Screen48::totalLineCycles - 8);
+    screen.setScreenMemory(shadow.data(), 16);
+    clock.advance(2 * Screen48::totalLineCycles);
+    screen.catchUp();
+
+    EXPECT_EQ(pixel(Screen48::borderWidth, Screen48::borderHeight + 1), Screen48::Renderer::borderColor(7));
+    EXPECT_EQ(pixel(Screen48::borderWidth, Screen48::borderHeight + 2), 0);
+}
+
+TEST_F(ScreenTest, NewFrameStartsWithLastBorder)
+{
+    finishFrame();
+    clock.advance(Screen48::totalFrameCycles);
+    screen.setBorder(1, 0);
+    finishFrame();
+    finishFrame();
+
+    EXPECT_EQ(shown(0, 0), Screen48::Renderer::borderColor(1));
+}
+
+TEST_F(ScreenTest, IdleFramesReportNoChanges)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        clock.advance(Screen48::totalFrameCycles);
+        screen.catchUp();
+        clock.rebase(Screen48::totalFrameCycles);
+        screen.newFrame(clock.now());
+    }
+
+    EXPECT_TRUE(screen.dirtyRects().empty());
+}
+
+TEST_F(ScreenTest, ScreenWriteReportsItsCell)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        clock.rebase(0);
+        screen.newFrame(clock.now());
+    }
+
+    screen.beforeScreenWrite(0x0821, 0);
+    vram[0x0821] = 0xFF;
+    clock.advance(Screen48::totalFrameCycles);
+    screen.catchUp();
+    screen.newFrame(0);
+
+    ASSERT_EQ(screen.dirtyRects().size(), 1);
+    const DirtyRect rect = screen.dirtyRects()[0];
+    EXPECT_EQ(rect.x, Screen48::borderWidth + 8);
+    EXPECT_EQ(rect.y, Screen48::borderHeight + 9 * 8);
+    const int offset = (Screen48::borderHeight + 9 * 8) * Screen48::frameWidth + Screen48::borderWidth + 8;
+    EXPECT_EQ(screen.publishedPixels()[offset], 0);
+}
+
+TEST_F(ScreenTest, BorderChangeReportsBorderOnly)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        screen.newFrame(0);
+    }
+
+    screen.setBorder(3, 0);
+    screen.newFrame(0);
+
+    int area = 0;
+    for (const DirtyRect& rect : screen.dirtyRects())
+    {
+        area += rect.width * rect.height;
+    }
+    EXPECT_EQ(area, Screen48::frameWidth * Screen48::frameHeight - Screen48::screenWidth * Screen48::screenHeight);
+}
+
+TEST_F(ScreenTest, FinishLinesCompletesTopOfFrame)
+{
+    vram[0] = 0xFF;
+    vram[Screen48::attributeBase] = 0x07;
+    screen.setBorder(2, 0);
+
+    clock.advance(Screen48::lineDoneCycles(Screen48::borderHeight));
+    screen.finishLines(Screen48::borderHeight + 1);
+
+    EXPECT_EQ(pixel(0, 0), Screen48::Renderer::borderColor(2));
+    EXPECT_EQ(pixel(Screen48::frameWidth - 1, Screen48::borderHeight), Screen48::Renderer::borderColor(2));
+    EXPECT_EQ(pixel(Screen48::borderWidth, Screen48::borderHeight), Screen48::Renderer::borderColor(7));
+    EXPECT_EQ(pixel(0, Screen48::borderHeight + 1), 0);
+
+    screen.setBorder(3, 0);
+    finishFrame();
+    EXPECT_EQ(shown(0, 0), Screen48::Renderer::borderColor(2));
+    EXPECT_EQ(shown(0, Screen48::frameHeight - 1), Screen48::Renderer::borderColor(3));
+}
+
+TEST_F(ScreenTest, DrawsIntoCallerMemory)
+{
+    constexpr int stride = 300;
+    constexpr Screen48::Pixel untouched = 0x7FFF;
+    std::vector<Screen48::Pixel> target(stride * 208, untouched);
+    const auto at = [&](int x, int y) { return target[y * stride + x]; };
+
+    vram[0] = 0xFF;
+    vram[Screen48::attributeBase] = 0x07;
+    screen.setTarget(target.data(), stride * sizeof(Screen48::Pixel), {.x = 40, .y = 40, .width = 272, .height = 208});
+    finishFrame();
+
+    EXPECT_EQ(screen.publishedPixels(), target.data());
+    EXPECT_EQ(at(0, 0), Screen48::Renderer::borderColor(7));
+    EXPECT_EQ(at(8, 8), Screen48::Renderer::borderColor(7));
+    EXPECT_EQ(at(16, 8), Screen48::Renderer::borderColor(0));
+    EXPECT_EQ(at(271, 207), Screen48::Renderer::borderColor(7));
+    EXPECT_EQ(at(272, 0), untouched);
+    ASSERT_EQ(screen.dirtyRects().size(), 1);
+    EXPECT_EQ(screen.dirtyRects()[0].width, 272);
+    EXPECT_EQ(screen.dirtyRects()[0].height, 208);
+
+    finishFrame();
+    vram[0] = 0x0F;
+    screen.beforeScreenWrite(0, 0);
+    finishFrame();
+
+    EXPECT_EQ(at(8, 8), Screen48::Renderer::borderColor(0));
+    EXPECT_EQ(at(12, 8), Screen48::Renderer::borderColor(7));
+    ASSERT_EQ(screen.dirtyRects().size(), 1);
+    EXPECT_EQ(screen.dirtyRects()[0].x, 8);
+    EXPECT_EQ(screen.dirtyRects()[0].y, 8);
+    EXPECT_EQ(screen.dirtyRects()[0].width, 8);
+}
+
+TEST_F(ScreenTest, UlaPlusPaletteColoursAttributesAndBorder)
+{
+    vram[0] = 0xF0;
+    vram[Screen48::attributeBase] = 0x40 | 2 << 3 | 1;
+    screen.setPaletteEntry(16 + 1, 0x1C, 0);
+    screen.setPaletteEntry(16 + 8 + 2, 0x03, 0);
+    screen.setPaletteEntry(8 + 7, 0xE0, 0);
+    screen.setPaletteEnabled(true, 0);
+    finishFrame();
+
+    EXPECT_EQ(shown(Screen48::borderWidth, Screen48::borderHeight), Rgb555::rgb(255, 0, 0));
+    EXPECT_EQ(shown(Screen48::borderWidth + 4, Screen48::borderHeight), Rgb555::rgb(0, 0, 255));
+    EXPECT_EQ(shown(0, 0), Rgb555::rgb(0, 255, 0));
+
+    screen.setPaletteEnabled(false, 0);
+    finishFrame();
+    EXPECT_EQ(shown(0, 0), Screen48::Renderer::borderColor(7));
+    EXPECT_EQ(shown(Screen48::borderWidth + 4, Screen48::borderHeight), Rgb555::color(2, true));
+}
+
+TEST_F(ScreenTest, PaletteChangeKeepsLinesAlreadyShown)
+{
+    screen.setPaletteEntry(15, 0xE0, 0);
+    screen.setPaletteEnabled(true, 0);
+    finishFrame();
+
+    clock.advance(Screen48::lineDoneCycles(9));
+    screen.setPaletteEntry(15, 0x1C, 0);
+    finishFrame();
+
+    EXPECT_EQ(shown(0, 9), Rgb555::rgb(0, 255, 0));
+    EXPECT_EQ(shown(0, 10), Rgb555::rgb(255, 0, 0));
+}
+
+using ScreenTimex = Screen<ModelTC2048>;
+
+class TimexScreenTest : public ::testing::Test
+{
+  protected:
+    static constexpr int left{ScreenTimex::borderWidth * ScreenTimex::xScale};
+    static constexpr int top{ScreenTimex::borderHeight};
+    static constexpr int upper{ScreenTimex::timexBase};
+
+    void SetUp() override
+    {
+        screen.setScreenMemory(vram.data(), 0);
+    }
+
+    ScreenTimex::Pixel shown(int x, int y)
+    {
+        return screen.publishedPixels()[y * ScreenTimex::frameWidth + x];
+    }
+
+    static ScreenTimex::Pixel color(int index)
+    {
+        return ScreenTimex::Renderer::borderColor(index);
+    }
+
+    void finishFrame()
+    {
+        clock.advance(ScreenTimex::totalFrameCycles - clock.now());
+        screen.catchUp();
+        clock.rebase(ScreenTimex::totalFrameCycles);
+        screen.newFrame(clock.now());
+    }
+
+    Scheduler clock;
+    ScreenTimex screen{clock};
+    std::array<std::uint8_t, ScreenTimex::displaySize> vram{};
+};
+
+TEST_F(TimexScreenTest, AlternateScreenShowsUpperFile)
+{
+    vram[upper] = 0xFF;
+    vram[upper + ScreenTimex::attributeBase] = 0x03;
+    screen.setTimexMode(1, 0);
+    finishFrame();
+
+    EXPECT_EQ(shown(left, top), color(3));
+}
+
+TEST_F(TimexScreenTest, HiColourTakesAttributeForEachLine)
+{
+    vram[0] = 0xFF;
+    vram[0x100] = 0xFF;
+    vram[upper] = 0x02;
+    vram[upper + 0x100] = 0x04;
+    screen.setTimexMode(2, 0);
+    finishFrame();
+
+    EXPECT_EQ(shown(left, top), color(2));
+    EXPECT_EQ(shown(left, top + 1), color(4));
+}
+
+TEST_F(TimexScreenTest, StandardScreenAtDoubleWidth)
+{
+    vram[0] = 0x80;
+    vram[ScreenTimex::attributeBase] = 0x07;
+    finishFrame();
+
+    EXPECT_EQ(ScreenTimex::frameInfo.width, 704);
+    EXPECT_EQ(shown(left, top), color(7));
+    EXPECT_EQ(shown(left + 1, top), color(7));
+    EXPECT_EQ(shown(left + 2, top), color(0));
+    EXPECT_EQ(shown(ScreenTimex::frameWidth - 1, top), color(7));
+}
+
+TEST_F(TimexScreenTest, HiResShowsBothFilesSideBySide)
+{
+    vram[0] = 0xC0;
+    vram[upper] = 0x03;
+    screen.setTimexMode(6 | 1 << 3, 0);
+    finishFrame();
+
+    EXPECT_EQ(shown(left, top), color(1));
+    EXPECT_EQ(shown(left + 1, top), color(1));
+    EXPECT_EQ(shown(left + 2, top), color(6));
+    EXPECT_EQ(shown(left + 13, top), color(6));
+    EXPECT_EQ(shown(left + 14, top), color(1));
+    EXPECT_EQ(shown(left + 15, top), color(1));
+    EXPECT_EQ(shown(0, 0), color(6));
+}
+
+TEST_F(TimexScreenTest, DirtyRectsInOutputPixels)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        finishFrame();
+    }
+
+    screen.beforeScreenWrite(1, 0);
+    finishFrame();
+
+    ASSERT_EQ(screen.dirtyRects().size(), 1);
+    const DirtyRect& rect = screen.dirtyRects()[0];
+    EXPECT_EQ(rect.x, left + 16);
+    EXPECT_EQ(rect.width, 16);
+    EXPECT_EQ(rect.height, 8);
+}
+
+TEST_F(TimexScreenTest, CropRoundedToDoubleWidthCells)
+{
+    constexpr int stride = 400;
+    std::vector<ScreenTimex::Pixel> target(stride * 16);
+
+    screen.setTarget(target.data(), stride * sizeof(ScreenTimex::Pixel), {.x = 24, .y = 0, .width = 360, .height = 16});
+    finishFrame();
+
+    EXPECT_EQ(screen.outputBounds().width, 352);
+    ASSERT_EQ(screen.dirtyRects().size(), 1);
+    EXPECT_EQ(screen.dirtyRects()[0].x, 0);
+    EXPECT_EQ(screen.dirtyRects()[0].width, 352);
+}
+
+TEST_F(TimexScreenTest, UpperFileIgnoredOnStandardScreen)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        finishFrame();
+    }
+
+    screen.beforeScreenWrite(upper, 0);
+    finishFrame();
+    EXPECT_TRUE(screen.dirtyRects().empty());
+
+    screen.setTimexMode(1, 0);
+    for (int i = 0; i < 3; i++)
+    {
+        finishFrame();
+    }
+
+    screen.beforeScreenWrite(upper, 0);
+    finishFrame();
+    EXPECT_EQ(screen.dirtyRects().size(), 1);
+}
+
+TEST_F(TimexScreenTest, ModeChangeKeepsLinesAlreadyShown)
+{
+    vram[0x100] = 0xFF;
+    vram[0x200] = 0xFF;
+    vram[ScreenTimex::attributeBase] = 0x01;
+    vram[upper + 0x200] = 0x05;
+    finishFrame();
+
+    clock.advance(ScreenTimex::lineDoneCycles(top + 1));
+    screen.setTimexMode(2, 0);
+    finishFrame();
+
+    EXPECT_EQ(shown(left, top + 1), color(1));
+    EXPECT_EQ(shown(left, top + 2), color(5));
+}
+
+TEST_F(TimexScreenTest, ModeChangeAtTheTstateOfTheOut)
+{
+    vram[0x200] = 0xFF;
+    vram[0x300] = 0xFF;
+    vram[ScreenTimex::attributeBase] = 0x01;
+    vram[upper + 0x200] = 0x05;
+    vram[upper + 0x300] = 0x05;
+    finishFrame();
+
+    // An OUT whose write lands after the beam has fetched the third line.
+    clock.advance(ScreenTimex::cyclesToFirstByte + 2 * ScreenTimex::totalLineCycles - 8);
+    screen.setTimexMode(2, 16);
+    finishFrame();
+
+    EXPECT_EQ(shown(left, top + 2), color(1));
+    EXPECT_EQ(shown(left, top + 3), color(5));
+}
@@ -17,22 +17,145 @@
 
 #include <cstdint>
 
+enum class MachineModel : std::uint8_t
+{
+    ZX48K,
+    ZX128K,
+    ZXPlus2A,
+    Pentagon,
+    TC2048
+};
+
+enum WatchKind : std::uint8_t
+{
+    WatchRead = 1 << 0,
+    WatchWrite = 1 << 1,
+    WatchExecute = 1 << 2,
+    WatchPortRead = 1 << 3,
+    WatchPortWrite = 1 << 4
+};
+
+enum class StopReason : std::uint8_t
+{
+    FrameComplete,
+    Watchpoint
+};
+
+// Pixels are stored in native byte order; the 32-bit names give the byte
+// order in memory on little-endian hosts. Indexed8 carries colours 0-7, plus 8 for BRIGHT.
+enum class PixelFormat : std::uint8_t
+{
+    RGB555,
+    RGB565,
+    RGBA8888,
+    BGRA8888,
+    Indexed8
+};
+
+// Threaded rendering replays each frame on a worker thread while the
+// next one is emulated; processFrame then returns the frame before.
+enum class RenderMode : std::uint8_t
+{
+    Inline,
+    Threaded
+};
+
+// Receives the frame being drawn with its first `lines` output lines
+// complete. Called on the emulation thread from inside processFrame.
+using ScanlineCallback = void (*)(void* context, std::uint16_t lines, const void* pixels);
+
 struct FrameInfo
 {
     std::uint16_t width;
     std::uint16_t height;
     std::uint16_t bytesPerRow;
+    PixelFormat format;
+};
+
+struct DirtyRect
+{
+    std::uint16_t x;
+    std::uint16_t y;
+    std::uint16_t width;
+    std::uint16_t height;
 };
 
+// Stereo layouts name the AY channels from left to right and interleave
+// left and right samples; the beeper sits in the middle.
+enum class AudioLayout : std::uint8_t
+{
+    Mono,
+    StereoABC,
+    StereoACB
+};
+
+// capacity counts samples per channel. A sampleRate of zero means 44.1kHz.
 struct EmuAudioBuffer
 {
     float* buffer;
     std::uint32_t capacity;
+    AudioLayout layout;
+    std::uint32_t sampleRate;
+};
+
+// Smooth uses the Scale2x/Scale3x edge rules; at 4x it is Scale2x twice.
+enum class ScaleFilter : std::uint8_t
+{
+    Nearest,
+    Smooth
+};
+
+// Caller memory for a scaled copy of each completed frame, factor (2 to
+// 4) times the size of pixels, rows bytesPerRow apart.
+struct ScaledOutput
+{
+    void* pixels;
+    std::uint32_t bytesPerRow;
+    std::uint8_t factor;
+    ScaleFilter filter;
+};
+
+// Caller memory to draw frames into, rows bytesPerRow apart. The crop
+// picks part of the frame, with x and width in whole character cells:
+// multiples of 8, or of 16 on the double-width TC2048 frame. Other values
+// are rounded down. Leave it zero for the whole frame.
+struct FrameTarget
+{
+    void* pixels;
+    std::uint32_t bytesPerRow;
+    DirtyRect crop;
 };
 
 struct FrameData
 {
+    // A completed frame writes up to capacity samples, the frame's length
+    // at sampleRate: not a whole number, and a 48K frame is a little
+    // shorter than 20ms. Whatever does not fit is kept for the next call.
     EmuAudioBuffer audioBuffer;
-    void* pixels;
+    // Optional. The frame is drawn straight into it and comes back in
+    // pixels. A frame resumed after a watchpoint keeps the destination it
+    // started with. Ignored with RenderMode::Threaded.
+    FrameTarget target;
+    // Optional. Filled when the frame completes, not on a watchpoint stop.
+    ScaledOutput scaled;
+    // Optional. Completed frames come back averaged with the frame before,
+    // so flicker shows as a steady mix; scaling uses the blended frame.
+    // Has no effect with PixelFormat::Indexed8.
+    bool blendFrames;
+    // Valid until the next processFrame call; see Machine::acquireFrame
+    // for holding a frame longer. With RenderMode::Threaded frames come
+    // back one call late, so until the first has been rendered pixels is
+    // null, there are no dirty rectangles and nothing is blended or
+    // scaled.
+    const void* pixels;
     std::uint32_t audioSamplesProduced;
+    StopReason stopReason;
+    WatchKind watchKind;
+    std::uint16_t watchAddress;
+    // Regions of pixels that may differ from the previous frame, relative
+    // to the crop. When unchanged is set the whole frame is identical and
+    // the list is empty.
+    const DirtyRect* dirtyRects;
+    std::uint32_t dirtyRectCount;
+    bool unchanged;
 };
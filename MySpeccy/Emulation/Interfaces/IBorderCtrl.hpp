@@ -20,5 +20,6 @@ class IBorderCtrl
   public:
     virtual ~IBorderCtrl() = default;
 
-    virtual void setBorder(int) = 0;
+    // Takes effect cycle tstates into the current instruction.
+    virtual void setBorder(int border, int cycle) = 0;
 };
@@ -15,11 +15,55 @@
 //
 #pragma once
 
+#include <array>
+#include <cstdint>
+
+// The 64K address space as 16K pages a CPU can index itself. An access
+// whose flag is zero on its page goes straight to the page's pointer;
+// anything else has a side effect and must go through the bus.
+struct PageMap
+{
+    static constexpr int pageShift{14};
+    static constexpr int pageCount{0x10000 >> pageShift};
+    static constexpr int pageMask{(1 << pageShift) - 1};
+
+    static constexpr int pageOf(int addr)
+    {
+        return (addr >> pageShift) & (pageCount - 1);
+    }
+
+    // Touched on every access: the flags and read pointers share a cache line.
+    std::array<std::uint8_t, pageCount> readFlags;
+    std::array<std::uint8_t, pageCount> writeFlags;
+    std::array<std::uint8_t, pageCount> fetchFlags;
+    std::array<const std::uint8_t*, pageCount> readPages;
+    std::array<std::uint8_t*, pageCount> writePages;
+};
+
 class IBus
 {
   public:
     virtual ~IBus() = default;
 
-    virtual int read(int addr) const = 0;
-    virtual void write(int addr, int data) = 0;
+    // cycle is where in the current instruction the access starts, in
+    // tstates from its first, not counting contention: the clock only
+    // moves on by the instruction's length once it is done, so the bus
+    // adds cycle to it to find the tstate of the access itself.
+    virtual int read(int addr, int cycle) const = 0;
+    virtual void write(int addr, int data, int cycle) = 0;
+
+    // Opcode fetch (M1). Only memory tells it apart from a read.
+    virtual int fetch(int addr, int cycle) const
+    {
+        return read(addr, cycle);
+    }
+
+    // Stays valid, and up to date, for the bus's lifetime. The default
+    // flags every page, so each access goes through the calls above.
+    virtual const PageMap& pageMap() const
+    {
+        static constexpr PageMap viaBus{.readFlags{1, 1, 1, 1}, .writeFlags{1, 1, 1, 1}, .fetchFlags{1, 1, 1, 1},
+                                        .readPages{}, .writePages{}};
+        return viaBus;
+    }
 };
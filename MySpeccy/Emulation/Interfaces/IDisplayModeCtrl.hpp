@@ -0,0 +1,32 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+// Video modes beyond the standard ULA screen. Each change takes effect
+// cycle tstates into the current instruction.
+class IDisplayModeCtrl
+{
+  public:
+    virtual ~IDisplayModeCtrl() = default;
+
+    // Timex port 0xFF: screen mode in bits 0-2, hi-res ink in bits 3-5.
+    virtual void setTimexMode(int value, int cycle) = 0;
+
+    // ULAplus: one of 64 palette entries as GGGRRRBB, and whether
+    // attributes pick their colours from the palette.
+    virtual void setPaletteEntry(int index, int value, int cycle) = 0;
+    virtual void setPaletteEnabled(bool enabled, int cycle) = 0;
+};
@@ -0,0 +1,32 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <cstdint>
+
+class IScreenCtrl
+{
+  public:
+    virtual ~IScreenCtrl() = default;
+
+    // Switches the displayed bank cycle tstates into the current
+    // instruction.
+    virtual void setScreenMemory(const std::uint8_t* screen, int cycle) = 0;
+
+    // Called before a byte of the displayed screen memory is written,
+    // cycle tstates into the current instruction.
+    virtual void beforeScreenWrite(int offset, int cycle) = 0;
+};
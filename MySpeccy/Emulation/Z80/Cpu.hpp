@@ -31,7 +31,8 @@ class Cpu
 {
   public:
     Cpu(IBus& memory, IBus& io, CpuState* const extState = nullptr)
-        : memory{memory}, io{io}, state(extState != nullptr ? *extState : internalState), test{0x4000}
+        : memory{memory}, io{io}, pages{memory.pageMap()}, state(extState != nullptr ? *extState : internalState),
+          test{0x4000}
     {
         testFun();
         for (int i = 0; i < 192 * 32 + 24 * 32; i++)
@@ -58,12 +59,12 @@ class Cpu
     {
         for (int i = 0x4000; i < 0x4000 + 192 * 32; i++)
         {
-            memory.write(i, 0);
+            writeMemory(i, 0, 0);
         }
 
         for (int i = 0x4000 + 192 * 32; i < 0x4000 + 192 * 32 + 24 * 32; i++)
         {
-            memory.write(i, 0x38);
+            writeMemory(i, 0x38, 0);
         }
 
         // test = 0x4000;
@@ -80,11 +81,11 @@ class Cpu
 
     void writeRandomByte()
     {
-        memory.write(test, std::rand());
-        const int key = io.read(0xFE);
+        writeMemory(test, std::rand(), 0);
+        const int key = io.read(0xFE, 0);
         if ((key & 0x1F) != 0x1F)
         {
-            io.write(0xFE, test);
+            io.write(0xFE, test, 0);
         }
         ++test;
         if (test >= 0x4000 + 192 * 32 + 24 * 32)
@@ -102,9 +103,24 @@ class Cpu
     }
 
   private:
+    // Memory writes index the bus's page map and only make the virtual
+    // call for a page whose flag says the bus has to see the write. Reads
+    // and fetches get the same once the instruction core uses them.
+    void writeMemory(int addr, int data, int cycle)
+    {
+        const int page = PageMap::pageOf(addr);
+        if (pages.writeFlags[page] != 0)
+        {
+            memory.write(addr, data, cycle);
+            return;
+        }
+        pages.writePages[page][addr & PageMap::pageMask] = static_cast<std::uint8_t>(data);
+    }
+
     CpuState internalState;
     IBus& memory;
     IBus& io;
+    const PageMap& pages;
     CpuState& state;
     std::uint16_t test;
 };
@@ -0,0 +1,96 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+// Samples handed from the emulator to an audio callback on another
+// thread. One side only writes, the other only reads, and each owns the
+// counter it moves, so both finish in a bounded number of steps: no lock,
+// no retry loop. Counters only grow; the capacity is a power of two so
+// they wrap into the buffer with a mask.
+class AudioRing
+{
+  public:
+    // capacity in samples per channel.
+    AudioRing(std::size_t capacity, int channels)
+        : size_{std::bit_ceil(std::max<std::size_t>(capacity, 2))}, channels{std::size_t(channels)},
+          buffer{std::make_unique<float[]>(size_ * channels)}, written{0}, taken{0}
+    {
+    }
+
+    AudioRing(const AudioRing&) = delete;
+
+    std::size_t capacity() const
+    {
+        return size_;
+    }
+
+    // Either side; the other may move it at any time.
+    std::size_t fill() const
+    {
+        return written.load(std::memory_order_acquire) - taken.load(std::memory_order_acquire);
+    }
+
+    // Emulator side: stores as many of count samples as fit, returns how
+    // many did.
+    std::size_t write(const float* samples, std::size_t count)
+    {
+        const std::size_t head = written.load(std::memory_order_relaxed);
+        count = std::min(count, size_ - (head - taken.load(std::memory_order_acquire)));
+        store(samples, head, count);
+        written.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Callback side: takes up to count samples, returns how many it got.
+    std::size_t read(float* out, std::size_t count)
+    {
+        const std::size_t tail = taken.load(std::memory_order_relaxed);
+        count = std::min(count, written.load(std::memory_order_acquire) - tail);
+        load(out, tail, count);
+        taken.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+  private:
+    // Both copy in at most two pieces, the second from the buffer's start.
+    void store(const float* samples, std::size_t at, std::size_t count)
+    {
+        const std::size_t start = at & (size_ - 1);
+        const std::size_t first = std::min(count, size_ - start);
+        std::copy_n(samples, first * channels, buffer.get() + start * channels);
+        std::copy_n(samples + first * channels, (count - first) * channels, buffer.get());
+    }
+
+    void load(float* out, std::size_t at, std::size_t count) const
+    {
+        const std::size_t start = at & (size_ - 1);
+        const std::size_t first = std::min(count, size_ - start);
+        std::copy_n(buffer.get() + start * channels, first * channels, out);
+        std::copy_n(buffer.get(), (count - first) * channels, out + first * channels);
+    }
+
+    std::size_t size_;
+    std::size_t channels;
+    std::unique_ptr<float[]> buffer;
+    alignas(64) std::atomic<std::size_t> written;
+    alignas(64) std::atomic<std::size_t> taken;
+};
@@ -0,0 +1,291 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include "BlepBuffer.hpp"
+#include "Interfaces/API.hpp"
+#include "Scheduler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+// AY-3-8912 clocked at half the CPU clock. It only runs when a register is
+// written or the frame ends, and then jumps from one counter event to the
+// next rather than ticking: between events nothing it outputs can change.
+// Changes of the mixed output go to the audio buffer as steps.
+class AyChip
+{
+  public:
+    // The tone counters advance once every 8 chip clocks.
+    static constexpr int cyclesPerTick{16};
+    static constexpr int registerCount{16};
+
+    AyChip(const Scheduler& clock, BlepBuffer& audio, int frameCycles)
+        : clock{clock}, audio{audio}, frameCycles{frameCycles}, position{0}, selected{0}, regs{}, toneCount{},
+          toneHigh{}, noiseCount{0}, noiseShift{1}, envelopeCount{0}, envelopeStep{0}, envelopeVolume{0},
+          envelopeAttack{false}, envelopeHolding{true}, gains{pans[0]}, output{}
+    {
+    }
+
+    AyChip(const AyChip&) = delete;
+
+    // Port 0xFFFD.
+    void select(int data)
+    {
+        selected = std::uint8_t(data);
+    }
+
+    int read() const
+    {
+        return selected < registerCount ? regs[selected] : 0xFF;
+    }
+
+    // Port 0xBFFD, cycle tstates into the instruction. The chip is caught
+    // up first so the old value covers everything before the write.
+    void write(int data, int cycle)
+    {
+        if (selected >= registerCount)
+        {
+            return;
+        }
+        catchUp(clock.now() + cycle);
+        regs[selected] = std::uint8_t(data & masks[selected]);
+        if (selected == 13)
+        {
+            restartEnvelope();
+        }
+        emit();
+    }
+
+    // Takes effect from the next output change.
+    void setLayout(AudioLayout layout)
+    {
+        gains = pans[static_cast<int>(layout)];
+    }
+
+    // Called before the clock is rebased.
+    void endFrame()
+    {
+        catchUp(frameCycles);
+        position -= frameCycles;
+    }
+
+    int envelope() const
+    {
+        return envelopeVolume;
+    }
+
+  private:
+    using Gains = std::array<std::array<float, 3>, 2>;
+
+    static constexpr std::array<std::uint8_t, registerCount> masks{0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0x1F, 0xFF,
+                                                                   0x1F, 0x1F, 0x1F, 0xFF, 0xFF, 0x0F, 0xFF, 0xFF};
+
+    // Measured DAC output, roughly 3dB a step.
+    static constexpr std::array<float, 16> volumes{0.0f,    0.0137f, 0.0205f, 0.0291f, 0.0423f, 0.0618f,
+                                                   0.0847f, 0.1369f, 0.1691f, 0.2647f, 0.3527f, 0.4499f,
+                                                   0.5704f, 0.6873f, 0.8482f, 1.0f};
+
+    // Per layout, how much of channels A, B and C goes left and right.
+    // Mono mixes the two sides, so any balanced layout does.
+    static constexpr float gain{0.4f};
+    static constexpr std::array<Gains, 3> pans{{
+        {{{gain, gain / 2, 0.0f}, {0.0f, gain / 2, gain}}},
+        {{{gain, gain / 2, 0.0f}, {0.0f, gain / 2, gain}}},
+        {{{gain, 0.0f, gain / 2}, {0.0f, gain, gain / 2}}},
+    }};
+
+    int tonePeriod(int channel) const
+    {
+        return std::max(1, regs[2 * channel] | regs[2 * channel + 1] << 8);
+    }
+
+    int noisePeriod() const
+    {
+        return 2 * std::max(1, int(regs[6]));
+    }
+
+    int envelopePeriod() const
+    {
+        return 2 * std::max(1, regs[11] | regs[12] << 8);
+    }
+
+    bool toneOn(int channel) const
+    {
+        return (regs[7] >> channel & 1) == 0;
+    }
+
+    bool noiseOn(int channel) const
+    {
+        return (regs[7] >> (channel + 3) & 1) == 0;
+    }
+
+    bool usesEnvelope(int channel) const
+    {
+        return (regs[8 + channel] & 0x10) != 0;
+    }
+
+    int volume(int channel) const
+    {
+        return usesEnvelope(channel) ? envelopeVolume : regs[8 + channel] & 0x0F;
+    }
+
+    // Ticks until a counter at count reaches period. One left over from a
+    // longer period fires on the next tick.
+    static int remaining(int count, int period)
+    {
+        return count < period ? period - count : 1;
+    }
+
+    // Moves a counter on by run ticks and returns how often it fired.
+    static int count(int& counter, int period, int run)
+    {
+        const int first = remaining(counter, period);
+        if (run < first)
+        {
+            counter += run;
+            return 0;
+        }
+        counter = (run - first) % period;
+        return 1 + (run - first) / period;
+    }
+
+    // Counters nobody can hear are left out; advance still keeps them
+    // going so they are in step when they come back.
+    int ticksToEvent() const
+    {
+        int ticks = std::numeric_limits<int>::max();
+        bool noise = false;
+        bool envelope = false;
+        for (int channel = 0; channel < 3; channel++)
+        {
+            if (!usesEnvelope(channel) && volume(channel) == 0)
+            {
+                continue;
+            }
+            envelope |= usesEnvelope(channel);
+            noise |= noiseOn(channel);
+            if (toneOn(channel))
+            {
+                ticks = std::min(ticks, remaining(toneCount[channel], tonePeriod(channel)));
+            }
+        }
+        if (noise)
+        {
+            ticks = std::min(ticks, remaining(noiseCount, noisePeriod()));
+        }
+        if (envelope && !envelopeHolding)
+        {
+            ticks = std::min(ticks, remaining(envelopeCount, envelopePeriod()));
+        }
+        return ticks;
+    }
+
+    void catchUp(int target)
+    {
+        while (position < target)
+        {
+            const int run = std::min(ticksToEvent(), (target - position + cyclesPerTick - 1) / cyclesPerTick);
+            advance(run);
+            position += run * cyclesPerTick;
+            emit();
+        }
+    }
+
+    void advance(int run)
+    {
+        for (int channel = 0; channel < 3; channel++)
+        {
+            toneHigh[channel] ^= count(toneCount[channel], tonePeriod(channel), run) & 1;
+        }
+        for (int shifts = count(noiseCount, noisePeriod(), run); shifts > 0; shifts--)
+        {
+            noiseShift = noiseShift >> 1 | ((noiseShift ^ noiseShift >> 3) & 1) << 16;
+        }
+        for (int steps = count(envelopeCount, envelopePeriod(), run); steps > 0 && !envelopeHolding; steps--)
+        {
+            stepEnvelope();
+        }
+    }
+
+    void restartEnvelope()
+    {
+        envelopeCount = 0;
+        envelopeStep = 0;
+        envelopeAttack = (regs[13] & 4) != 0;
+        envelopeHolding = false;
+        envelopeVolume = envelopeAttack ? 0 : 15;
+    }
+
+    // Shape bits: 3 continue, 2 attack, 1 alternate, 0 hold. Without
+    // continue the envelope ends at zero; with hold it stays where the
+    // first ramp ended, or at the other end when alternating.
+    void stepEnvelope()
+    {
+        if (++envelopeStep == 16)
+        {
+            const int shape = regs[13];
+            const bool alternate = (shape & 2) != 0;
+            if ((shape & 8) == 0 || (shape & 1) != 0)
+            {
+                envelopeHolding = true;
+                envelopeVolume = (shape & 8) != 0 && envelopeAttack != alternate ? 15 : 0;
+                return;
+            }
+            envelopeAttack ^= alternate;
+            envelopeStep = 0;
+        }
+        envelopeVolume = envelopeAttack ? envelopeStep : 15 - envelopeStep;
+    }
+
+    void emit()
+    {
+        std::array<float, 2> mixed{};
+        for (int channel = 0; channel < 3; channel++)
+        {
+            const bool tone = toneHigh[channel] != 0 || !toneOn(channel);
+            const bool noise = (noiseShift & 1) != 0 || !noiseOn(channel);
+            const float level = tone && noise ? volumes[volume(channel)] : 0.0f;
+            mixed[0] += gains[0][channel] * level;
+            mixed[1] += gains[1][channel] * level;
+        }
+        if (mixed != output)
+        {
+            audio.addStep(position, mixed[0] - output[0], mixed[1] - output[1]);
+            output = mixed;
+        }
+    }
+
+    const Scheduler& clock;
+    BlepBuffer& audio;
+    int frameCycles;
+    int position;
+    std::uint8_t selected;
+    std::array<std::uint8_t, registerCount> regs;
+    std::array<int, 3> toneCount;
+    std::array<std::uint8_t, 3> toneHigh;
+    int noiseCount;
+    std::uint32_t noiseShift;
+    int envelopeCount;
+    int envelopeStep;
+    int envelopeVolume;
+    bool envelopeAttack;
+    bool envelopeHolding;
+    Gains gains;
+    std::array<float, 2> output;
+};
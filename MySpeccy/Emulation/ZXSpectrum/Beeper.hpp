@@ -0,0 +1,54 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include "BlepBuffer.hpp"
+#include "Scheduler.hpp"
+
+#include <array>
+
+// The speaker on port 0xFE. Writes that leave the level alone cost a
+// compare; the rest become steps in the audio buffer.
+class Beeper
+{
+  public:
+    Beeper(const Scheduler& clock, BlepBuffer& audio) : clock{clock}, audio{audio}, bits{0}
+    {
+    }
+
+    Beeper(const Beeper&) = delete;
+
+    // Bits 3 (MIC) and 4 (EAR) of a port 0xFE write, cycle tstates into
+    // the instruction.
+    void setLevel(int data, int cycle)
+    {
+        const int next = (data >> 3) & 3;
+        if (next != bits)
+        {
+            const float delta = levels[next] - levels[bits];
+            audio.addStep(clock.now() + cycle, delta, delta);
+            bits = next;
+        }
+    }
+
+  private:
+    // EAR drives the speaker, MIC leaks into it faintly.
+    static constexpr std::array<float, 4> levels{0.0f, 0.06f, 0.5f, 0.56f};
+
+    const Scheduler& clock;
+    BlepBuffer& audio;
+    int bits;
+};
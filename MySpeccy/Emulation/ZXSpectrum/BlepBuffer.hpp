@@ -0,0 +1,190 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+
+// Stereo audio made of level steps at cycle positions, one sample every
+// cyclesPerSample CPU cycles. Each step adds a band-limited copy of itself
+// to a buffer of sample deltas, and reading integrates them, so the work
+// follows the number of steps rather than the clock. The part of a sample
+// left at the end of a frame carries into the next.
+class BlepBuffer
+{
+  public:
+    // Step kernel: a windowed sinc at one of phases sub-sample offsets,
+    // taps samples long. A step lands taps / 2 - 1 samples late.
+    static constexpr int phases{16};
+    static constexpr int taps{16};
+
+    // Frames of samples kept for a caller that reads less than it should.
+    static constexpr int maxFrames{4};
+
+    using Kernel = std::array<std::array<float, taps>, phases>;
+    using Sample = std::array<float, 2>;
+
+    BlepBuffer(int cyclesPerSample, int frameCycles)
+        : cyclesPerSample{cyclesPerSample}, frameCycles{frameCycles}, start{0}, ready{0}, end{0},
+          limit{std::size_t(maxFrames) * (frameCycles / cyclesPerSample + 1)}, level{},
+          deltas(limit + 2 * (frameCycles / cyclesPerSample + 1) + taps)
+    {
+    }
+
+    BlepBuffer(const BlepBuffer&) = delete;
+
+    // A change of left and right at cycles into the current frame. Steps
+    // past the end of the frame are fine, they land at the start of the next.
+    void addStep(int cycles, float left, float right)
+    {
+        const int position = start + std::max(cycles, 0);
+        const std::size_t index = ready + std::size_t(position / cyclesPerSample);
+        if (index + taps > deltas.size())
+        {
+            return;
+        }
+
+        const auto& steps = kernel[position % cyclesPerSample * phases / cyclesPerSample];
+        Sample* to = deltas.data() + index;
+        for (int i = 0; i < taps; i++)
+        {
+            to[i][0] += left * steps[i];
+            to[i][1] += right * steps[i];
+        }
+        end = std::max(end, index + taps);
+    }
+
+    // Completes the samples up to the end of the frame. Called before the
+    // clock is rebased.
+    void endFrame()
+    {
+        const int position = start + frameCycles;
+        ready += std::size_t(position / cyclesPerSample);
+        start = position % cyclesPerSample;
+        if (ready > limit)
+        {
+            consume(nullptr, ready - limit, false);
+        }
+    }
+
+    // Samples completed and not yet read.
+    std::size_t available() const
+    {
+        return ready;
+    }
+
+    // Most samples kept unread; older ones are dropped.
+    std::size_t capacity() const
+    {
+        return limit;
+    }
+
+    // Copies up to capacity samples into out, either the two sides mixed
+    // or interleaved left and right; the rest wait for the next call.
+    std::uint32_t read(float* out, std::uint32_t capacity, bool stereo = false)
+    {
+        const std::size_t count = out ? std::min<std::size_t>(capacity, ready) : 0;
+        consume(out, count, stereo);
+        return std::uint32_t(count);
+    }
+
+    static const Kernel kernel;
+
+  private:
+    // About 7Hz at the 110kHz a sample every 32 cycles gives: lets the
+    // output settle back to zero so a level left high does not hold a DC
+    // offset.
+    static constexpr float leak{0.0004f};
+
+    // Integrates count samples into out, or drops them when out is null,
+    // and moves what is left to the front.
+    void consume(float* out, std::size_t count, bool stereo)
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            for (int side = 0; side < 2; side++)
+            {
+                level[side] += deltas[i][side];
+            }
+            if (out && stereo)
+            {
+                out[2 * i] = level[0];
+                out[2 * i + 1] = level[1];
+            }
+            else if (out)
+            {
+                out[i] = (level[0] + level[1]) * 0.5f;
+            }
+            for (int side = 0; side < 2; side++)
+            {
+                level[side] -= level[side] * leak;
+            }
+        }
+
+        const std::size_t used = std::max(end, count);
+        std::copy(deltas.begin() + count, deltas.begin() + used, deltas.begin());
+        std::fill(deltas.begin() + (used - count), deltas.begin() + used, Sample{});
+        end = used - count;
+        ready -= count;
+    }
+
+    int cyclesPerSample;
+    int frameCycles;
+    int start;
+    std::size_t ready;
+    std::size_t end;
+    std::size_t limit;
+    Sample level;
+    std::vector<Sample> deltas;
+};
+
+// Blackman-windowed sinc cut off a little below Nyquist, each phase scaled
+// to sum to one so a step reaches exactly its height. Not constexpr as the
+// standard library's sin and cos are not until C++26.
+inline BlepBuffer::Kernel makeBlepKernel()
+{
+    BlepBuffer::Kernel kernel{};
+    constexpr int taps = BlepBuffer::taps;
+    constexpr double cutoff = 0.9;
+    constexpr double pi = std::numbers::pi;
+
+    for (int phase = 0; phase < BlepBuffer::phases; phase++)
+    {
+        double sum = 0.0;
+        std::array<double, taps> values{};
+        for (int i = 0; i < taps; i++)
+        {
+            const double x = i - (taps / 2 - 1) - double(phase) / BlepBuffer::phases;
+            const double u = (x + taps / 2) / taps;
+            const double window = 0.42 - 0.5 * std::cos(2 * pi * u) + 0.08 * std::cos(4 * pi * u);
+            const double sinc = x == 0.0 ? 1.0 : std::sin(pi * cutoff * x) / (pi * cutoff * x);
+            values[i] = sinc * window;
+            sum += values[i];
+        }
+        for (int i = 0; i < taps; i++)
+        {
+            kernel[phase][i] = float(values[i] / sum);
+        }
+    }
+    return kernel;
+}
+
+inline const BlepBuffer::Kernel BlepBuffer::kernel{makeBlepKernel()};
@@ -0,0 +1,93 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include "Models.hpp"
+#include "Scheduler.hpp"
+#include "Screen.hpp"
+
+#include <array>
+#include <cstdint>
+
+// ULA contention delays indexed by frame tstate. The ULA halts the CPU
+// while it fetches screen bytes, repeating the model's 8-tstate pattern
+// across the 128 tstates of each paper line.
+template <typename Model> class Contention
+{
+  public:
+    using Screen = ::Screen<Model>;
+
+    static constexpr int firstCycle{Model::contentionStart};
+    static constexpr int lineCycles{Screen::screenWidth / Screen::pixelsPerCycle};
+    static constexpr auto pattern{Model::contentionPattern};
+
+    using Table = std::array<std::uint8_t, Screen::totalFrameCycles + Scheduler::maxOverrun>;
+
+    static int memory(int tstate)
+    {
+        return table[tstate];
+    }
+
+    // Port accesses take 4 tstates. The ULA decodes even ports and the
+    // high byte of the port sits on the address bus, so either can contend.
+    static int io(int port, int tstate, bool highContended)
+    {
+        const bool ula = (port & 1) == 0;
+        int delay = 0;
+
+        if (highContended)
+        {
+            delay += table[tstate];
+            if (ula)
+            {
+                delay += table[tstate + delay + 1];
+            }
+            else
+            {
+                for (int i = 1; i < 4; i++)
+                {
+                    delay += table[tstate + delay + i];
+                }
+            }
+        }
+        else if (ula)
+        {
+            delay += table[tstate + 1];
+        }
+
+        return delay;
+    }
+
+  private:
+    static constexpr Table makeTable()
+    {
+        Table result{};
+        for (int line = 0; line < Screen::screenHeight; line++)
+        {
+            const int lineStart = firstCycle + line * Screen::totalLineCycles;
+            for (int i = 0; i < lineCycles; i++)
+            {
+                result[lineStart + i] = pattern[i % pattern.size()];
+            }
+        }
+        return result;
+    }
+
+    static const Table table;
+};
+
+template <typename Model>
+inline constexpr typename Contention<Model>::Table Contention<Model>::table{Contention<Model>::makeTable()};
@@ -0,0 +1,162 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include "Interfaces/API.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+// Per-frame dirty bits for the cells of the output frame, 8 lines high
+// and CellWidth pixels wide, one 64-bit mask per cell row. A change is
+// marked for the current frame and the next one, since the beam may
+// already have passed the cell.
+//
+// With several frame buffers in rotation, a buffer coming back into use
+// also has to catch up with every change made since it was last drawn;
+// those cells are kept per buffer and folded in when drawing starts. The
+// reported changes stay relative to the previous frame.
+template <int Columns, int Rows, int Buffers = 1, int CellWidth = 8> class DirtyCells
+{
+  public:
+    static_assert(Columns <= 64);
+
+    static constexpr int cellSize{8};
+    static constexpr int cellWidth{CellWidth};
+
+    using Row = std::uint64_t;
+    using Mask = std::array<Row, Rows>;
+
+    static constexpr Row allColumns{Columns == 64 ? ~Row{0} : (Row{1} << Columns) - 1};
+
+    // Nothing has been drawn yet, so every buffer starts entirely dirty.
+    DirtyCells() : next{}, drawing{0}
+    {
+        current.fill(allColumns);
+        changed.fill(allColumns);
+        for (auto& mask : stale)
+        {
+            mask.fill(allColumns);
+        }
+        stale[drawing].fill(0);
+    }
+
+    bool dirty(int column, int row) const
+    {
+        return ((current[row] >> column) & 1) != 0;
+    }
+
+    void mark(int column, int row)
+    {
+        markRow(row, Row{1} << column);
+    }
+
+    void markRow(int row, Row columns)
+    {
+        current[row] |= columns;
+        changed[row] |= columns;
+        next[row] |= columns;
+    }
+
+    // Hands the finished frame's changes over as rectangles in pixels and
+    // starts the next frame with whatever was carried over. Runs that line
+    // up with a rectangle ending on the row above extend it downwards.
+    void endFrame(std::vector<DirtyRect>& rects)
+    {
+        rects.clear();
+        std::array<std::size_t, Columns> open;
+        std::array<std::size_t, Columns> touched;
+        int openCount = 0;
+
+        for (int row = 0; row < Rows; row++)
+        {
+            int touchedCount = 0;
+            Row columns = changed[row];
+
+            while (columns != 0)
+            {
+                const int first = std::countr_zero(columns);
+                const int length = std::countr_one(columns >> first);
+                columns &= first + length >= 64 ? 0 : ~Row{0} << (first + length);
+
+                const auto x = static_cast<std::uint16_t>(first * cellWidth);
+                const auto width = static_cast<std::uint16_t>(length * cellWidth);
+
+                const auto above = std::find_if(open.begin(), open.begin() + openCount, [&](std::size_t i) {
+                    return rects[i].x == x && rects[i].width == width;
+                });
+
+                if (above != open.begin() + openCount)
+                {
+                    rects[*above].height += cellSize;
+                    touched[touchedCount++] = *above;
+                }
+                else
+                {
+                    rects.push_back({.x = x, .y = std::uint16_t(row * cellSize), .width = width, .height = cellSize});
+                    touched[touchedCount++] = rects.size() - 1;
+                }
+            }
+
+            open = touched;
+            openCount = touchedCount;
+        }
+
+        for (int buffer = 0; buffer < Buffers; buffer++)
+        {
+            if (buffer != drawing)
+            {
+                for (int row = 0; row < Rows; row++)
+                {
+                    stale[buffer][row] |= changed[row];
+                }
+            }
+        }
+
+        current = next;
+        changed = next;
+        next.fill(0);
+    }
+
+    // Picks the buffer the frame is drawn into, adding whatever it missed
+    // while others were in use. Due before the first cell is drawn.
+    void drawInto(int buffer)
+    {
+        for (int row = 0; row < Rows; row++)
+        {
+            current[row] |= stale[buffer][row];
+        }
+        stale[buffer].fill(0);
+        drawing = buffer;
+    }
+
+    // The buffer's contents are unknown: draw every cell into it, without
+    // counting that as a change.
+    void redraw()
+    {
+        current.fill(allColumns);
+    }
+
+  private:
+    Mask current;
+    Mask changed;
+    Mask next;
+    std::array<Mask, Buffers> stale;
+    int drawing;
+};
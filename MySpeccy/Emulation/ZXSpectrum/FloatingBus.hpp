@@ -0,0 +1,79 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include "Models.hpp"
+#include "Scheduler.hpp"
+#include "Screen.hpp"
+
+#include <array>
+#include <cstdint>
+
+// What the ULA has on the data bus at each frame tstate: the offset into
+// screen memory it is fetching, or idle. Each 8-tstate group of a paper
+// line fetches bitmap, attribute, bitmap, attribute for two columns and
+// leaves the bus idle for the other four tstates.
+template <typename Model> class FloatingBus
+{
+  public:
+    using Screen = ::Screen<Model>;
+
+    static constexpr std::uint16_t idle{0xFFFF};
+
+    using Table = std::array<std::uint16_t, Screen::totalFrameCycles + Scheduler::maxOverrun>;
+
+    static int read(const std::uint8_t* vram, int tstate)
+    {
+        const auto offset = table[tstate];
+        return offset == idle ? 0xFF : vram[offset];
+    }
+
+    static int offset(int tstate)
+    {
+        return table[tstate];
+    }
+
+  private:
+    static constexpr int columnsPerGroup{2};
+    static constexpr int groupCycles{8};
+
+    static constexpr Table makeTable()
+    {
+        Table result{};
+        result.fill(idle);
+        for (int line = 0; line < Screen::screenHeight; line++)
+        {
+            const int lineStart = Screen::cyclesToFirstByte + line * Screen::totalLineCycles;
+            const int pixelLine = ((line & 0xC0) << 5) | ((line & 7) << 8) | ((line & 0x38) << 2);
+            const int attrLine = Screen::attributeBase + (line >> 3) * 32;
+
+            for (int column = 0; column < Screen::screenWidth / 8; column += columnsPerGroup)
+            {
+                const int groupStart = lineStart + column / columnsPerGroup * groupCycles;
+                result[groupStart + 0] = pixelLine + column;
+                result[groupStart + 1] = attrLine + column;
+                result[groupStart + 2] = pixelLine + column + 1;
+                result[groupStart + 3] = attrLine + column + 1;
+            }
+        }
+        return result;
+    }
+
+    static const Table table;
+};
+
+template <typename Model>
+inline constexpr typename FloatingBus<Model>::Table FloatingBus<Model>::table{FloatingBus<Model>::makeTable()};
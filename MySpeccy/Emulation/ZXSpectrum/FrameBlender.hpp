@@ -0,0 +1,214 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Interfaces/API.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FRAME_BLENDER_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define FRAME_BLENDER_NEON 1
+#endif
+
+// Shows each frame as the average of itself and the one before, so
+// sprites drawn every other frame and screens alternated at 50Hz come out
+// as the steady mix a CRT would have shown. Keeps its own copy of the
+// previous frame and of the blended result. A cell is only blended again
+// when it changed in this frame or the last; anywhere else both frames
+// already agree.
+template <typename Format> class FrameBlender
+{
+  public:
+    using Pixel = typename Format::Pixel;
+
+    // Averaging needs channels, so palette formats cannot be blended.
+    static constexpr bool supported{requires { Format::lowBits; }};
+
+    FrameBlender() : width{0}, height{0}
+    {
+    }
+
+    FrameBlender(const FrameBlender&) = delete;
+
+    // Forgets the previous frame; the next one is shown as it is.
+    void reset()
+    {
+        width = 0;
+        height = 0;
+    }
+
+    // Takes a completed frame and the rectangles that changed since the
+    // one before, and returns the blended frame, width pixels per row.
+    // Without a frame there is nothing to show, and the rectangles of the
+    // next one cannot be trusted, so it starts over like after reset().
+    const Pixel* blend(const Pixel* frame, std::size_t stride, int width, int height,
+                       std::span<const DirtyRect> changed)
+    {
+        if (frame == nullptr)
+        {
+            reset();
+            rects.clear();
+            return nullptr;
+        }
+
+        if (width != this->width || height != this->height)
+        {
+            this->width = width;
+            this->height = height;
+            previous.resize(std::size_t(width) * height);
+            blended.resize(previous.size());
+
+            const DirtyRect whole{.x = 0, .y = 0, .width = std::uint16_t(width), .height = std::uint16_t(height)};
+            copy(frame, stride, whole, previous);
+            copy(frame, stride, whole, blended);
+            rects.assign(1, whole);
+            lastChanged.clear();
+            return blended.data();
+        }
+
+        rects.assign(lastChanged.begin(), lastChanged.end());
+        rects.insert(rects.end(), changed.begin(), changed.end());
+        for (const DirtyRect& rect : rects)
+        {
+            for (int y = rect.y; y < rect.y + rect.height; y++)
+            {
+                const std::size_t row = std::size_t(y) * width + rect.x;
+                average(frame + y * stride + rect.x, previous.data() + row, blended.data() + row, rect.width);
+            }
+        }
+
+        for (const DirtyRect& rect : changed)
+        {
+            copy(frame, stride, rect, previous);
+        }
+        lastChanged.assign(changed.begin(), changed.end());
+
+        return blended.data();
+    }
+
+    // Rectangles of the blended frame that differ from the last one.
+    std::span<const DirtyRect> dirtyRects() const
+    {
+        return rects;
+    }
+
+    // Per-channel average, rounding down: the shared bits plus half the
+    // differing ones, with each channel's lowest bit cleared so the shift
+    // cannot carry into the channel below.
+    static void average(const Pixel* a, const Pixel* b, Pixel* out, int count)
+    {
+        int i = 0;
+#if defined(FRAME_BLENDER_SSE2)
+        const __m128i high = broadcast(Pixel(~Format::lowBits));
+        for (; i + lanes <= count; i += lanes)
+        {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            const __m128i half = halve(_mm_and_si128(_mm_xor_si128(x, y), high));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), add(_mm_and_si128(x, y), half));
+        }
+#elif defined(FRAME_BLENDER_NEON)
+        if constexpr (sizeof(Pixel) == 2)
+        {
+            const uint16x8_t high = vdupq_n_u16(Pixel(~Format::lowBits));
+            for (; i + 8 <= count; i += 8)
+            {
+                const uint16x8_t x = vld1q_u16(a + i);
+                const uint16x8_t y = vld1q_u16(b + i);
+                vst1q_u16(out + i, vaddq_u16(vandq_u16(x, y), vshrq_n_u16(vandq_u16(veorq_u16(x, y), high), 1)));
+            }
+        }
+        else
+        {
+            const uint32x4_t high = vdupq_n_u32(Pixel(~Format::lowBits));
+            for (; i + 4 <= count; i += 4)
+            {
+                const uint32x4_t x = vld1q_u32(a + i);
+                const uint32x4_t y = vld1q_u32(b + i);
+                vst1q_u32(out + i, vaddq_u32(vandq_u32(x, y), vshrq_n_u32(vandq_u32(veorq_u32(x, y), high), 1)));
+            }
+        }
+#endif
+        for (; i < count; i++)
+        {
+            out[i] = Pixel((a[i] & b[i]) + (((a[i] ^ b[i]) & Pixel(~Format::lowBits)) >> 1));
+        }
+    }
+
+  private:
+#if defined(FRAME_BLENDER_SSE2)
+    static constexpr int lanes{16 / sizeof(Pixel)};
+
+    static __m128i broadcast(Pixel pixel)
+    {
+        if constexpr (sizeof(Pixel) == 2)
+        {
+            return _mm_set1_epi16(static_cast<short>(pixel));
+        }
+        else
+        {
+            return _mm_set1_epi32(static_cast<int>(pixel));
+        }
+    }
+
+    static __m128i halve(__m128i v)
+    {
+        if constexpr (sizeof(Pixel) == 2)
+        {
+            return _mm_srli_epi16(v, 1);
+        }
+        else
+        {
+            return _mm_srli_epi32(v, 1);
+        }
+    }
+
+    static __m128i add(__m128i a, __m128i b)
+    {
+        if constexpr (sizeof(Pixel) == 2)
+        {
+            return _mm_add_epi16(a, b);
+        }
+        else
+        {
+            return _mm_add_epi32(a, b);
+        }
+    }
+#endif
+
+    void copy(const Pixel* frame, std::size_t stride, const DirtyRect& rect, std::vector<Pixel>& to) const
+    {
+        for (int y = rect.y; y < rect.y + rect.height; y++)
+        {
+            std::copy_n(frame + y * stride + rect.x, rect.width, to.data() + std::size_t(y) * width + rect.x);
+        }
+    }
+
+    int width;
+    int height;
+    std::vector<Pixel> previous;
+    std::vector<Pixel> blended;
+    std::vector<DirtyRect> lastChanged;
+    std::vector<DirtyRect> rects;
+};
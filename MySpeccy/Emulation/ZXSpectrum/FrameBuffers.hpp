@@ -0,0 +1,159 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Three frame buffers handed between the emulator and a consumer that may
+// run on another thread. The emulator always owns one buffer to draw into;
+// a finished frame becomes Ready, and the consumer holds it from
+// acquire() until release() while the emulator carries on in the third.
+// Buffer states are packed into one atomic word, so nothing is copied
+// and no lock is taken.
+template <typename Pixel, std::size_t Size> class FrameBuffers
+{
+  public:
+    static constexpr int count{3};
+
+    using Buffer = std::array<Pixel, Size>;
+
+    FrameBuffers() : buffers{std::make_unique<std::array<Buffer, count>>()}, state{pack(0, Writing)}, back{0}, ready{0}
+    {
+    }
+
+    FrameBuffers(const FrameBuffers&) = delete;
+
+    int backIndex() const
+    {
+        return back;
+    }
+
+    Pixel* backBuffer()
+    {
+        return (*buffers)[back].data();
+    }
+
+    // Most recently published frame, for a consumer on the emulator thread.
+    const Pixel* published() const
+    {
+        return (*buffers)[ready].data();
+    }
+
+    // Emulator side: marks the back buffer Ready, dropping any older frame
+    // the consumer did not take, and moves on to a free buffer.
+    void publish()
+    {
+        std::uint32_t current = state.load(std::memory_order_relaxed);
+        std::uint32_t next;
+        int free;
+        do
+        {
+            next = replace(current, Ready, Free);
+            next = with(next, back, Ready);
+            free = find(next, Free);
+            next = with(next, free, Writing);
+        } while (!state.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+        ready = back;
+        back = free;
+    }
+
+    // Consumer side: takes the newest Ready frame, implicitly releasing the
+    // one held before. Returns nullptr when nothing new has been published.
+    const Pixel* acquire()
+    {
+        std::uint32_t current = state.load(std::memory_order_acquire);
+        std::uint32_t next;
+        int index;
+        do
+        {
+            index = find(current, Ready);
+            if (index < 0)
+            {
+                return nullptr;
+            }
+            next = with(replace(current, Held, Free), index, Held);
+        } while (!state.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_acquire));
+
+        return (*buffers)[index].data();
+    }
+
+    void release()
+    {
+        std::uint32_t current = state.load(std::memory_order_relaxed);
+        while (!state.compare_exchange_weak(current, replace(current, Held, Free), std::memory_order_release,
+                                            std::memory_order_relaxed))
+        {
+        }
+    }
+
+  private:
+    enum Slot : std::uint32_t
+    {
+        Free = 0,
+        Writing,
+        Ready,
+        Held
+    };
+
+    static constexpr std::uint32_t pack(int index, Slot slot)
+    {
+        return std::uint32_t(slot) << (index * 2);
+    }
+
+    static constexpr Slot get(std::uint32_t word, int index)
+    {
+        return Slot((word >> (index * 2)) & 3);
+    }
+
+    static constexpr std::uint32_t with(std::uint32_t word, int index, Slot slot)
+    {
+        return (word & ~pack(index, Slot(3))) | pack(index, slot);
+    }
+
+    static constexpr std::uint32_t replace(std::uint32_t word, Slot from, Slot to)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (get(word, i) == from)
+            {
+                word = with(word, i, to);
+            }
+        }
+        return word;
+    }
+
+    static constexpr int find(std::uint32_t word, Slot slot)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (get(word, i) == slot)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    std::unique_ptr<std::array<Buffer, count>> buffers;
+    std::atomic<std::uint32_t> state;
+    int back;
+    int ready;
+};
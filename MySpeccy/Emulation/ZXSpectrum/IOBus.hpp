@@ -15,43 +15,142 @@
 //
 #pragma once
 
+#include "AyChip.hpp"
+#include "Beeper.hpp"
+#include "Contention.hpp"
+#include "FloatingBus.hpp"
 #include "Interfaces/IBorderCtrl.hpp"
 #include "Interfaces/IBus.hpp"
+#include "Interfaces/IDisplayModeCtrl.hpp"
+#include "Memory.hpp"
+#include "Models.hpp"
+#include "Scheduler.hpp"
+#include "Watchpoints.hpp"
 
 #include <array>
 #include <cstdint>
 
-class IOBus : public IBus
+template <typename Model> class IOBus : public IBus
 {
   public:
-    IOBus(IBorderCtrl& borderCtrl) : borderCtrl{borderCtrl}, columns{}
+    static constexpr int portPageShift{12};
+    static constexpr int portPageCount{0x10000 >> portPageShift};
+
+    // ULAplus decodes the full address.
+    static constexpr int plusSelectPort{0xBF3B};
+    static constexpr int plusDataPort{0xFF3B};
+
+    // The AY decodes A15, A14 and A1: 0xFFFD selects, 0xBFFD writes.
+    static constexpr int ayMask{0xC002};
+    static constexpr int aySelect{0xC000};
+    static constexpr int ayData{0x8000};
+
+    IOBus(IBorderCtrl& borderCtrl, IDisplayModeCtrl& displayCtrl, Beeper& beeper, AyChip& ay, Memory<Model>& memory,
+          Scheduler& clock, Watchpoints& watchpoints)
+        : borderCtrl{borderCtrl}, displayCtrl{displayCtrl}, beeper{beeper}, ay{ay}, memory{memory}, clock{clock},
+          watchpoints{watchpoints}, columns{}, watchFlags{}, plusSelect{0}, plusMode{0}, palette{}, timexMode{0}
     {
     }
 
     IOBus(const IOBus&) = delete;
 
-    int read(int addr) const final override
+    int read(int addr, int cycle) const final override
     {
+        contend(addr, cycle);
+        watch(addr, WatchPortRead);
+        if (addr == plusDataPort)
+        {
+            return (plusSelect & 0xC0) == 0 ? palette[plusSelect & 63] : plusMode;
+        }
+        if constexpr (Model::ay)
+        {
+            if ((addr & ayMask) == aySelect)
+            {
+                return ay.read();
+            }
+        }
+        if constexpr (Model::timexScreen)
+        {
+            if ((addr & 0xFF) == 0xFF)
+            {
+                return timexMode;
+            }
+        }
+        if ((addr & 1) != 0)
+        {
+            // Nothing drives the bus, so the CPU sees whatever the ULA is
+            // fetching at the tstate of the read.
+            if constexpr (Model::floatingBus)
+            {
+                return FloatingBus<Model>::read(memory.screenMemory(), clock.now() + cycle);
+            }
+            else
+            {
+                return 0xFF;
+            }
+        }
+
         int result = 0xFF;
-        if ((addr & 1) == 0)
+        for (int i = 0; i < 8; i++)
         {
-            for (int i = 0; i < 8; i++)
+            if ((addr & 0x100) == 0)
             {
-                if ((addr & 0x100) == 0)
-                {
-                    result &= ~columns[i];
-                }
-                addr >>= 1;
+                result &= ~columns[i];
             }
+            addr >>= 1;
         }
         return result;
     }
 
-    void write(int addr, int data) final override
+    void write(int addr, int data, int cycle) final override
     {
+        contend(addr, cycle);
+        watch(addr, WatchPortWrite);
         if ((addr & 1) == 0)
         {
-            borderCtrl.setBorder(data & 7);
+            borderCtrl.setBorder(data & 7, cycle);
+            beeper.setLevel(data, cycle);
+        }
+        if constexpr (Model::paging)
+        {
+            if ((addr & Model::pagingPortMask) == Model::pagingPort)
+            {
+                memory.setPaging(data, cycle);
+            }
+        }
+        if constexpr (Model::plus3Paging)
+        {
+            if ((addr & Model::plus3PortMask) == Model::plus3Port)
+            {
+                memory.setPlus3Paging(data, cycle);
+            }
+        }
+        if constexpr (Model::timexScreen)
+        {
+            if ((addr & 0xFF) == 0xFF)
+            {
+                timexMode = std::uint8_t(data);
+                displayCtrl.setTimexMode(data, cycle);
+            }
+        }
+        if constexpr (Model::ay)
+        {
+            if ((addr & ayMask) == aySelect)
+            {
+                ay.select(data);
+            }
+            else if ((addr & ayMask) == ayData)
+            {
+                ay.write(data, cycle);
+            }
+        }
+        if (addr == plusSelectPort)
+        {
+            plusSelect = std::uint8_t(data);
+        }
+        else if (addr == plusDataPort)
+        {
+            writePlus(data, cycle);
         }
     }
 
@@ -65,7 +164,59 @@ class IOBus : public IBus
         columns[key >> 5] &= ~(key & 0x1F);
     }
 
+    void updateWatchpoints()
+    {
+        for (int page = 0; page < portPageCount; page++)
+        {
+            const int first = page << portPageShift;
+            watchFlags[page] = watchpoints.kinds(first, first + (1 << portPageShift) - 1);
+        }
+    }
+
   private:
+    // Register group in bits 6-7 of the select port: palette entries, or
+    // the mode register whose bit 0 turns the palette on.
+    void writePlus(int data, int cycle)
+    {
+        if ((plusSelect & 0xC0) == 0)
+        {
+            palette[plusSelect & 63] = std::uint8_t(data);
+            displayCtrl.setPaletteEntry(plusSelect & 63, data, cycle);
+        }
+        else if ((plusSelect & 0xC0) == 0x40)
+        {
+            plusMode = std::uint8_t(data);
+            displayCtrl.setPaletteEnabled((data & 1) != 0, cycle);
+        }
+    }
+
+    void watch(int addr, WatchKind kind) const
+    {
+        if ((watchFlags[(addr >> portPageShift) & (portPageCount - 1)] & kind) != 0)
+        {
+            watchpoints.check(kind, addr);
+        }
+    }
+
+    void contend(int addr, int cycle) const
+    {
+        if constexpr (Model::ioContended)
+        {
+            clock.advance(Contention<Model>::io(addr, clock.now() + cycle, memory.isContended(addr)));
+        }
+    }
+
     IBorderCtrl& borderCtrl;
+    IDisplayModeCtrl& displayCtrl;
+    Beeper& beeper;
+    AyChip& ay;
+    Memory<Model>& memory;
+    Scheduler& clock;
+    Watchpoints& watchpoints;
     std::array<std::uint8_t, 8> columns;
+    std::array<std::uint8_t, portPageCount> watchFlags;
+    std::uint8_t plusSelect;
+    std::uint8_t plusMode;
+    std::array<std::uint8_t, 64> palette;
+    std::uint8_t timexMode;
 };
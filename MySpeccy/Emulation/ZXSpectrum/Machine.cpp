@@ -16,92 +16,511 @@
 
 #include "Machine.hpp"
 #include "IOBus.hpp"
+#include "AudioRing.hpp"
+#include "AyChip.hpp"
+#include "Beeper.hpp"
+#include "BlepBuffer.hpp"
+#include "FrameBlender.hpp"
 #include "Memory.hpp"
+#include "Models.hpp"
+#include "PixelFormats.hpp"
+#include "RateControl.hpp"
+#include "RenderThread.hpp"
+#include "Resampler.hpp"
+#include "Scaler.hpp"
+#include "Scheduler.hpp"
 #include "Screen.hpp"
+#include "Watchpoints.hpp"
 #include "Z80/Cpu.hpp"
 
 #include <algorithm>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
+#include <memory>
+#include <span>
+#include <vector>
 
 using Z80::Cpu;
+using Z80::CpuState;
 
-class Machine::Impl : public IVSyncCtrl
+class Machine::Impl
 {
   public:
-    Impl() : screen{memory.screenBus(), *this}, ioBus{screen}, cpu{memory, ioBus}, audioSamples{0}, intCycles{0}
+    virtual ~Impl() = default;
+
+    virtual FrameInfo frameInfo() const = 0;
+    virtual void processFrame(FrameData&) = 0;
+    virtual void keyDown(uint32_t) = 0;
+    virtual void keyUp(uint32_t) = 0;
+    virtual void loadROM(const uint8_t*, uint32_t) = 0;
+    virtual void addWatchpoint(uint8_t, uint16_t, uint16_t) = 0;
+    virtual void clearWatchpoints() = 0;
+    virtual const void* acquireFrame() = 0;
+    virtual void releaseFrame() = 0;
+    virtual void setScanlineCallback(uint16_t, ScanlineCallback, void*) = 0;
+    virtual void setAudioRing(uint32_t, uint32_t, AudioLayout) = 0;
+    virtual uint32_t readAudio(float*, uint32_t) = 0;
+};
+
+namespace
+{
+
+template <typename Model, typename Format> class ModelImpl final : public Machine::Impl
+{
+  public:
+    using Screen = ::Screen<Model, Format>;
+
+    explicit ModelImpl(RenderMode mode)
+        : peripherals{std::make_unique<Peripherals>(scheduler, mode)},
+          memory{scheduler, peripherals->screenCtrl(), peripherals->watchpoints},
+          ioBus{peripherals->borderCtrl(), peripherals->displayCtrl(), peripherals->beeper, peripherals->ay, memory,
+                scheduler, peripherals->watchpoints},
+          cpu{memory, ioBus, &cpuState}, renderThread{peripherals->renderThread.get()},
+          watchpoints{peripherals->watchpoints}, audio{peripherals->audio}, ay{peripherals->ay},
+          screen{peripherals->screen}, ringRate{0}, ringLayout{AudioLayout::Mono}, scanlineCallback{nullptr},
+          scanlineContext{nullptr}, scanlineInterval{0}, nextScanline{0}
     {
         std::srand(std::time({}));
+        peripherals->screenCtrl().setScreenMemory(memory.screenMemory(), 0);
+        scheduler.schedule(Scheduler::Event::FrameEnd, Screen::totalFrameCycles);
     }
 
-    FrameInfo frameInfo() const
+    FrameInfo frameInfo() const final override
     {
         return Screen::frameInfo;
     }
 
-    void vSync(int cycles) final override
+    void processFrame(FrameData& data) final override
     {
-        isVSync = 1;
-        vSyncCycles = std::min<int>(cycles, 255);
-    }
+        if (!renderThread)
+        {
+            screen.setTarget(data.target.pixels, data.target.bytesPerRow, data.target.crop);
+        }
+        ay.setLayout(ring ? ringLayout : data.audioBuffer.layout);
 
-    void processFrame(FrameData& data)
-    {
-        isVSync = 0;
-        int lastCycles = 0;
-        while (isVSync == 0)
+        Event event;
+        do
         {
-            lastCycles = cpu.executeOne();
-            if (intCycles > 0)
+            while (!scheduler.due())
             {
-                intCycles = std::max<int>(static_cast<int>(intCycles) - lastCycles, 0);
-                if (intCycles == 0)
-                {
-                    cpu.clearIterrupt();
-                }
+                scheduler.advance(cpu.executeOne());
             }
-            screen.runCycles(lastCycles);
+            event = scheduler.pop();
+        } while (dispatch(event));
+
+        if (event == Event::Break)
+        {
+            data.pixels = renderThread ? renderThread->pixels() : screen.pixels();
+            const auto hit = watchpoints.lastHit();
+            data.stopReason = StopReason::Watchpoint;
+            data.watchKind = hit.kind;
+            data.watchAddress = hit.address;
+            data.dirtyRects = renderThread ? &Screen::fullFrame : &screen.outputBounds();
+            data.dirtyRectCount = data.pixels != nullptr ? 1 : 0;
+            data.unchanged = false;
+            data.audioSamplesProduced = 0;
+            return;
         }
-        const int vSyncBefore = lastCycles - vSyncCycles;
-        intCycles = std::max<int>(32 - vSyncBefore, 0);
-        if (intCycles > 0)
+
+        // The render thread has nothing to hand back until its first frame
+        // is done, and then there is nothing to blend or scale either.
+        Frame frame = completedFrame();
+        if (frame.pixels != nullptr)
         {
-            cpu.setInterrupt();
+            blendFrame(frame, data.blendFrames);
+            scaleFrame(data.scaled, frame);
         }
 
-        data.pixels = screen.pixels();
-        std::fill_n(data.audioBuffer.buffer, 882, 0);
-        data.audioSamplesProduced = 882;
+        data.pixels = frame.pixels;
+        data.stopReason = StopReason::FrameComplete;
+        data.dirtyRects = frame.rects.data();
+        data.dirtyRectCount = static_cast<std::uint32_t>(frame.rects.size());
+        data.unchanged = frame.pixels != nullptr && frame.rects.empty();
+        if (ring)
+        {
+            feedRing();
+            data.audioSamplesProduced = 0;
+        }
+        else
+        {
+            resampleAudio(data.audioBuffer.sampleRate, 1.0);
+            data.audioSamplesProduced = resampler.pull(data.audioBuffer.buffer, data.audioBuffer.capacity,
+                                                       data.audioBuffer.layout != AudioLayout::Mono);
+        }
     }
 
-    void keyDown(uint32_t key)
+    void keyDown(uint32_t key) final override
     {
         ioBus.keyDown(key);
     }
 
-    void keyUp(uint32_t key)
+    void keyUp(uint32_t key) final override
     {
         ioBus.keyUp(key);
     }
 
-    void loadROM(const uint8_t* data, uint32_t size)
+    void loadROM(const uint8_t* data, uint32_t size) final override
     {
         memory.loadRom(std::span<const uint8_t>(data, size));
     }
 
+    void addWatchpoint(uint8_t kinds, uint16_t first, uint16_t last) final override
+    {
+        watchpoints.add(kinds, first, last);
+        memory.updateWatchpoints();
+        ioBus.updateWatchpoints();
+    }
+
+    void clearWatchpoints() final override
+    {
+        watchpoints.clear();
+        memory.updateWatchpoints();
+        ioBus.updateWatchpoints();
+    }
+
+    // The render thread takes frames itself to hand them out from
+    // processFrame.
+    const void* acquireFrame() final override
+    {
+        return renderThread ? nullptr : screen.acquireFrame();
+    }
+
+    void releaseFrame() final override
+    {
+        if (!renderThread)
+        {
+            screen.releaseFrame();
+        }
+    }
+
+    void setScanlineCallback(uint16_t lines, ScanlineCallback callback, void* context) final override
+    {
+        scheduler.cancel(Event::Scanline);
+        if (renderThread || lines == 0 || callback == nullptr)
+        {
+            scanlineInterval = 0;
+            return;
+        }
+
+        scanlineCallback = callback;
+        scanlineContext = context;
+        scanlineInterval = lines;
+
+        int next = lines;
+        while (next < Screen::frameHeight && Screen::lineDoneCycles(next - 1) <= scheduler.now())
+        {
+            next += lines;
+        }
+        scheduleScanline(next);
+    }
+
+    // Starts half full of silence, so the first callbacks have something
+    // while the emulator gets going.
+    void setAudioRing(uint32_t capacity, uint32_t sampleRate, AudioLayout layout) final override
+    {
+        ring.reset();
+        ringRate = sampleRate;
+        ringLayout = layout;
+        rateControl.reset();
+        if (capacity != 0)
+        {
+            ring = std::make_unique<AudioRing>(capacity, channels(layout));
+            ringAudio.assign(ring->capacity() / 2 * channels(layout), 0.0f);
+            ring->write(ringAudio.data(), ring->capacity() / 2);
+        }
+    }
+
+    uint32_t readAudio(float* out, uint32_t count) final override
+    {
+        const std::size_t taken = ring ? ring->read(out, count) : 0;
+        std::fill(out + taken * channels(ringLayout), out + count * channels(ringLayout), 0.0f);
+        return static_cast<uint32_t>(taken);
+    }
+
   private:
-    Memory memory;
-    Screen screen;
-    IOBus ioBus;
+    using Event = Scheduler::Event;
+    using Pixel = typename Format::Pixel;
+    using Blender = FrameBlender<Format>;
+
+    // Internal audio rate, about 110kHz: well above anything audible, and
+    // a sample every other AY tick.
+    static constexpr int cyclesPerSample{2 * AyChip::cyclesPerTick};
+
+    // Everything the buses reach only on a port write, a screen write or a
+    // trap, allocated on its own so it stays out of the cache lines the
+    // CPU touches every instruction. With a render thread the screen
+    // belongs to the worker and the buses only talk to the log.
+    struct Peripherals
+    {
+        Peripherals(Scheduler& scheduler, RenderMode mode)
+            : renderThread{mode == RenderMode::Threaded ? std::make_unique<RenderThread<Screen>>(scheduler, screen)
+                                                        : nullptr},
+              watchpoints{scheduler}, audio{cyclesPerSample, Model::totalFrameCycles}, beeper{scheduler, audio},
+              ay{scheduler, audio, Model::totalFrameCycles},
+              screen{renderThread ? renderThread->replayClock() : scheduler}
+        {
+        }
+
+        // The worker must stop before the screen it draws into goes away.
+        ~Peripherals()
+        {
+            renderThread.reset();
+        }
+
+        IScreenCtrl& screenCtrl()
+        {
+            return renderThread ? static_cast<IScreenCtrl&>(*renderThread) : screen;
+        }
+
+        IBorderCtrl& borderCtrl()
+        {
+            return renderThread ? static_cast<IBorderCtrl&>(*renderThread) : screen;
+        }
+
+        IDisplayModeCtrl& displayCtrl()
+        {
+            return renderThread ? static_cast<IDisplayModeCtrl&>(*renderThread) : screen;
+        }
+
+        std::unique_ptr<RenderThread<Screen>> renderThread;
+        Watchpoints watchpoints;
+        BlepBuffer audio;
+        Beeper beeper;
+        AyChip ay;
+        Screen screen;
+    };
+
+    // A completed frame as handed to the host; stride is in pixels.
+    struct Frame
+    {
+        const Pixel* pixels;
+        std::size_t stride;
+        int width;
+        int height;
+        std::span<const DirtyRect> rects;
+    };
+
+    Frame completedFrame() const
+    {
+        if (renderThread)
+        {
+            return {renderThread->pixels(), Screen::frameWidth, Screen::frameWidth, Screen::frameHeight,
+                    renderThread->dirtyRects()};
+        }
+        return {screen.publishedPixels(), screen.publishedStride(), screen.publishedWidth(), screen.publishedHeight(),
+                screen.dirtyRects()};
+    }
+
+    static int channels(AudioLayout layout)
+    {
+        return layout == AudioLayout::Mono ? 1 : 2;
+    }
+
+    // Moves the frame's internal samples into the resampler at the ratio
+    // for the host's rate, times adjust.
+    void resampleAudio(std::uint32_t sampleRate, double adjust)
+    {
+        const std::uint32_t rate = sampleRate != 0 ? sampleRate : Resampler::defaultOutputRate;
+        resampler.setRatio(double(Model::cpuClock) / cyclesPerSample / rate * adjust);
+
+        internalAudio.resize(2 * audio.available());
+        const std::uint32_t count = audio.read(internalAudio.data(), std::uint32_t(audio.available()), true);
+        resampler.push(internalAudio.data(), count);
+    }
+
+    // Tops the ring up with the frame's audio, at a ratio nudged towards
+    // keeping it half full. What does not fit waits in the resampler.
+    void feedRing()
+    {
+        resampleAudio(ringRate, rateControl.update(ring->fill(), ring->capacity() / 2));
+        const std::size_t room = ring->capacity() - ring->fill();
+        ringAudio.resize(room * channels(ringLayout));
+        const std::uint32_t count = resampler.pull(ringAudio.data(), std::uint32_t(room), channels(ringLayout) == 2);
+        ring->write(ringAudio.data(), count);
+    }
+
+    void blendFrame(Frame& frame, bool enabled)
+    {
+        if constexpr (Blender::supported)
+        {
+            if (enabled)
+            {
+                frame.pixels = blender.blend(frame.pixels, frame.stride, frame.width, frame.height, frame.rects);
+                frame.stride = frame.width;
+                frame.rects = blender.dirtyRects();
+            }
+            else
+            {
+                blender.reset();
+            }
+        }
+    }
+
+    void scaleFrame(const ScaledOutput& out, const Frame& frame)
+    {
+        if (out.pixels != nullptr)
+        {
+            scaler.scale(frame.pixels, frame.stride, frame.width, frame.height, static_cast<Pixel*>(out.pixels),
+                         out.bytesPerRow / sizeof(Pixel), out.factor, out.filter);
+        }
+    }
+
+    void scheduleScanline(int lines)
+    {
+        nextScanline = std::min(lines, int(Screen::frameHeight));
+        scheduler.schedule(Event::Scanline, Screen::lineDoneCycles(nextScanline - 1));
+    }
+
+    // Returns false once the frame is complete or a watchpoint was hit.
+    bool dispatch(Event event)
+    {
+        switch (event)
+        {
+        case Event::IntEnd:
+            cpu.clearIterrupt();
+            return true;
+
+        case Event::FrameEnd:
+            if (renderThread)
+            {
+                renderThread->endFrame();
+            }
+            else
+            {
+                screen.catchUp();
+            }
+            if constexpr (Model::ay)
+            {
+                ay.endFrame();
+            }
+            audio.endFrame();
+            scheduler.rebase(Screen::totalFrameCycles);
+            scheduler.schedule(Event::FrameEnd, Screen::totalFrameCycles);
+            if (!renderThread)
+            {
+                screen.newFrame(scheduler.now());
+            }
+            if (scanlineInterval != 0)
+            {
+                scheduleScanline(scanlineInterval);
+            }
+            if (scheduler.now() < Model::intLength)
+            {
+                cpu.setInterrupt();
+                scheduler.schedule(Event::IntEnd, Model::intLength);
+            }
+            return false;
+
+        case Event::Scanline:
+            screen.finishLines(nextScanline);
+            scanlineCallback(scanlineContext, nextScanline, screen.pixels());
+            if (nextScanline < Screen::frameHeight)
+            {
+                scheduleScanline(nextScanline + scanlineInterval);
+            }
+            return true;
+
+        case Event::Break:
+            if (!renderThread)
+            {
+                screen.catchUp();
+            }
+            return false;
+
+        default:
+            return true;
+        }
+    }
+
+    // Per-instruction state first: registers and clock share a cache line
+    // with the vtable pointer, and the page map follows straight after,
+    // then the buses and the CPU. The peripherals are built before the
+    // buses that refer to them but live in their own allocation, as do
+    // bulk RAM and the frame buffer.
+    CpuState cpuState;
+    Scheduler scheduler;
+    std::unique_ptr<Peripherals> peripherals;
+    Memory<Model> memory;
+    IOBus<Model> ioBus;
     Cpu cpu;
-    std::uint32_t audioSamples;
-    std::uint8_t vSyncCycles;
-    std::uint8_t intCycles;
-    uint8_t isVSync : 1;
+    RenderThread<Screen>* renderThread;
+    Watchpoints& watchpoints;
+    BlepBuffer& audio;
+    AyChip& ay;
+    Screen& screen;
+    Resampler resampler;
+    std::vector<float> internalAudio;
+    std::unique_ptr<AudioRing> ring;
+    std::uint32_t ringRate;
+    AudioLayout ringLayout;
+    RateControl rateControl;
+    std::vector<float> ringAudio;
+    Scaler<Pixel> scaler;
+    Blender blender;
+    ScanlineCallback scanlineCallback;
+    void* scanlineContext;
+    int scanlineInterval;
+    int nextScanline;
 };
 
-Machine::Machine() : impl{std::make_unique<Machine::Impl>()}
+template <typename Model> std::unique_ptr<Machine::Impl> makeImpl(PixelFormat format, RenderMode mode)
+{
+    switch (format)
+    {
+    case PixelFormat::RGB565:
+        return std::make_unique<ModelImpl<Model, Rgb565>>(mode);
+
+    case PixelFormat::RGBA8888:
+        return std::make_unique<ModelImpl<Model, Rgba8888>>(mode);
+
+    case PixelFormat::BGRA8888:
+        return std::make_unique<ModelImpl<Model, Bgra8888>>(mode);
+
+    case PixelFormat::Indexed8:
+        return std::make_unique<ModelImpl<Model, Indexed8>>(mode);
+
+    default:
+        return std::make_unique<ModelImpl<Model, Rgb555>>(mode);
+    }
+}
+
+std::unique_ptr<Machine::Impl> makeImpl(MachineModel model, PixelFormat format, RenderMode mode)
+{
+    switch (model)
+    {
+    case MachineModel::ZX128K:
+        return makeImpl<Model128K>(format, mode);
+
+    case MachineModel::ZXPlus2A:
+        return makeImpl<ModelPlus2A>(format, mode);
+
+    case MachineModel::Pentagon:
+        return makeImpl<ModelPentagon>(format, mode);
+
+    case MachineModel::TC2048:
+        return makeImpl<ModelTC2048>(format, mode);
+
+    default:
+        return makeImpl<Model48K>(format, mode);
+    }
+}
+
+} // namespace
+
+Machine::Machine() : Machine{MachineModel::ZX48K}
+{
+}
+
+Machine::Machine(MachineModel model) : Machine{model, PixelFormat::RGB555}
+{
+}
+
+Machine::Machine(MachineModel model, PixelFormat format) : Machine{model, format, RenderMode::Inline}
+{
+}
+
+Machine::Machine(MachineModel model, PixelFormat format, RenderMode mode) : impl{makeImpl(model, format, mode)}
 {
 }
 
@@ -133,3 +552,38 @@ void Machine::loadROM(const uint8_t* data, uint32_t size)
 {
     impl->loadROM(data, size);
 }
+
+void Machine::addWatchpoint(uint8_t kinds, uint16_t first, uint16_t last)
+{
+    impl->addWatchpoint(kinds, first, last);
+}
+
+void Machine::clearWatchpoints()
+{
+    impl->clearWatchpoints();
+}
+
+const void* Machine::acquireFrame()
+{
+    return impl->acquireFrame();
+}
+
+void Machine::releaseFrame()
+{
+    impl->releaseFrame();
+}
+
+void Machine::setScanlineCallback(uint16_t lines, ScanlineCallback callback, void* context)
+{
+    impl->setScanlineCallback(lines, callback, context);
+}
+
+void Machine::setAudioRing(uint32_t capacity, uint32_t sampleRate, AudioLayout layout)
+{
+    impl->setAudioRing(capacity, sampleRate, layout);
+}
+
+uint32_t Machine::readAudio(float* out, uint32_t count)
+{
+    return impl->readAudio(out, count);
+}
@@ -24,6 +24,9 @@ class Machine
 {
   public:
     Machine();
+    explicit Machine(MachineModel);
+    Machine(MachineModel, PixelFormat);
+    Machine(MachineModel, PixelFormat, RenderMode);
     Machine(Machine&&) noexcept;
 
     Machine(const Machine&) = delete;
@@ -37,7 +40,40 @@ class Machine
     void keyUp(uint32_t);
     void loadROM(const uint8_t*, uint32_t);
 
-  private:
+    // kinds is a mask of WatchKind. A hit stops processFrame early with
+    // StopReason::Watchpoint; the next call resumes mid-frame.
+    void addWatchpoint(uint8_t kinds, uint16_t first, uint16_t last);
+    void clearWatchpoints();
+
+    // For a presenter on another thread: returns the newest completed frame,
+    // or nullptr if none was finished since the last call. The pixels stay
+    // untouched until releaseFrame() or the next acquireFrame(), while
+    // emulation continues in another buffer. Frames drawn into a
+    // FrameTarget are not handed out here, nor are any with
+    // RenderMode::Threaded.
+    const void* acquireFrame();
+    void releaseFrame();
+
+    // Beam racing: calls back every `lines` completed output lines so a
+    // host can present the top of the frame while the rest is emulated.
+    // Zero lines or a null callback turns it off. Inline rendering only.
+    void setScanlineCallback(uint16_t lines, ScanlineCallback callback, void* context);
+
+    // Sends audio through a ring instead of FrameData::audioBuffer, which
+    // is then ignored: processFrame tops it up and readAudio drains it.
+    // The resampling ratio is nudged by up to half a percent to keep the
+    // ring half full, so emulation paced by the display neither runs dry
+    // nor overflows. capacity counts samples per channel; zero turns the
+    // ring off. Call while the audio thread is not reading.
+    void setAudioRing(uint32_t capacity, uint32_t sampleRate, AudioLayout layout);
+
+    // For the host's audio callback, on any one thread: fills out with
+    // count samples without blocking, silence for any the ring could not
+    // supply, and returns how many came from the ring.
+    uint32_t readAudio(float* out, uint32_t count);
+
     class Impl;
+
+  private:
     std::unique_ptr<Impl> impl;
 };
@@ -15,87 +15,297 @@
 //
 #pragma once
 
+#include "Contention.hpp"
+#include "Interfaces/API.hpp"
 #include "Interfaces/IBus.hpp"
+#include "Interfaces/IScreenCtrl.hpp"
+#include "Models.hpp"
+#include "RomImage.hpp"
+#include "Scheduler.hpp"
+#include "Watchpoints.hpp"
 
 #include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstdlib>
 #include <ctime>
+#include <memory>
 #include <span>
 
-class Memory : public IBus
+template <typename Model> class Memory : public IBus
 {
   public:
-    using ByteSpan = std::span<std::uint8_t>;
+    static constexpr int pageShift{PageMap::pageShift};
+    static constexpr int pageSize{1 << pageShift};
+    static constexpr int pageMask{PageMap::pageMask};
+    static constexpr int pageCount{PageMap::pageCount};
 
-    static constexpr std::size_t romSize{0x4000};
-    static constexpr std::size_t ramSize{0xC000};
-    static constexpr std::size_t screenOffset{0};
-    static constexpr std::size_t screenSize{0x5B00};
-    static constexpr std::size_t attrOffset{192 * 32};
-    static constexpr std::size_t attrSize{24 * 32};
+    static constexpr std::size_t romSize{RomImage::pageSize};
+    // Without paging only banks 5, 2 and 0 can be mapped, so only they
+    // are stored.
+    static constexpr std::size_t ramBanks{Model::paging ? 8 : 3};
+    // Timex modes also display a second file 0x2000 bytes up.
+    static constexpr std::size_t screenSize{Model::timexScreen ? 0x3B00 : 0x1B00};
+    static constexpr int normalScreenBank{5};
+    static constexpr int shadowScreenBank{7};
 
-    Memory() : screenBus_{std::span{ram}.subspan(screenOffset, screenSize)}
+    // Port 0x7FFD layout.
+    static constexpr int pagingBankMask{0x07};
+    static constexpr int pagingShadowScreen{0x08};
+    static constexpr int pagingRom{0x10};
+    static constexpr int pagingLock{0x20};
+
+    // Port 0x1FFD layout on the +2A. Bit 2 is the high bit of the ROM
+    // number; in special mode bits 1-2 pick one of four all-RAM maps.
+    static constexpr int plus3Special{0x01};
+    static constexpr int plus3RomHigh{0x04};
+    static constexpr std::array<std::array<std::uint8_t, pageCount>, 4> specialBanks{
+        {{0, 1, 2, 3}, {4, 5, 6, 7}, {4, 5, 6, 3}, {4, 7, 6, 3}}};
+
+    using Page = std::array<std::uint8_t, pageSize>;
+
+    // Accesses to a page with any flag set leave the fast path, the CPU's
+    // own included.
+    enum PageFlag : std::uint8_t
+    {
+        Contended = 1 << 0,
+        Watched = 1 << 1,
+        Display = 1 << 2,
+    };
+
+    // Without contention the lookups compile out.
+    static constexpr bool contended{Model::contended};
+
+    // A model without paging is the 128K memory map locked from reset:
+    // ROM 0, banks 5, 2 and 0, and nothing else is allocated.
+    Memory(Scheduler& clock, IScreenCtrl& screenCtrl, Watchpoints& watchpoints)
+        : pages{}, watchFlags{}, clock{clock}, screenCtrl{screenCtrl}, watchpoints{watchpoints}, paging{0}, plus3{0},
+          locked{false}, rom{RomImage::blank()}, storage{std::make_unique<Storage>()}
     {
+        page(Model::paging ? 0 : pagingLock);
     }
 
     Memory(const Memory&) = delete;
 
     void loadRom(std::span<const std::uint8_t> content)
     {
-        const auto copySize = std::min(content.size(), rom.size());
-        std::copy(content.begin(), content.begin() + copySize, rom.begin());
+        rom = RomImage::intern(content);
+        remap();
+    }
+
+    // Bank switching only swaps page pointers; nothing is copied. The
+    // screen only hears about it when the displayed bank moves, cycle
+    // tstates into the OUT.
+    void setPaging(int value, int cycle)
+    {
+        if (locked)
+        {
+            return;
+        }
+
+        const std::uint8_t* shown = screenMemory();
+        page(value);
+        screenMoved(shown, cycle);
+    }
+
+    // Port 0x1FFD, locked along with 0x7FFD. Other models ignore it.
+    void setPlus3Paging(int value, int cycle)
+    {
+        if constexpr (Model::plus3Paging)
+        {
+            if (locked)
+            {
+                return;
+            }
+
+            const std::uint8_t* shown = screenMemory();
+            plus3 = value;
+            remap();
+            screenMoved(shown, cycle);
+        }
+    }
+
+    int read(int addr, int cycle) const final override
+    {
+        const int page = pageOf(addr);
+        if (pages.readFlags[page] != 0)
+        {
+            trap(page, addr, WatchRead, cycle);
+        }
+        return pages.readPages[page][addr & pageMask];
     }
 
-    int read(int addr) const final override
+    int fetch(int addr, int cycle) const final override
     {
-        addr &= 0xFFFF;
-        if (addr < romSize)
+        const int page = pageOf(addr);
+        if (pages.fetchFlags[page] != 0)
         {
-            return rom[addr];
+            trap(page, addr, WatchExecute, cycle);
         }
-        return ram[addr - romSize];
+        return pages.readPages[page][addr & pageMask];
     }
 
-    void write(int addr, int data) final override
+    void write(int addr, int data, int cycle) final override
     {
-        addr &= 0xFFFF;
-        if (addr >= romSize)
+        const int page = pageOf(addr);
+        if (pages.writeFlags[page] != 0)
         {
-            ram[addr - romSize] = data;
+            trap(page, addr, WatchWrite, cycle);
         }
+        pages.writePages[page][addr & pageMask] = data;
     }
 
-    const IBus& screenBus()
+    // The same tables read() and write() use, for a CPU to skip the call.
+    const PageMap& pageMap() const final override
     {
-        return screenBus_;
+        return pages;
+    }
+
+    // Watches belong to CPU addresses, so they stay put across bank switches.
+    void updateWatchpoints()
+    {
+        for (int page = 0; page < pageCount; page++)
+        {
+            watchFlags[page] = watchpoints.kinds(page << pageShift, (page << pageShift) | pageMask);
+            updateFlags(page);
+        }
+    }
+
+    const std::uint8_t* screenMemory() const
+    {
+        return bankMemory((paging & pagingShadowScreen) != 0 ? shadowScreenBank : normalScreenBank);
+    }
+
+    bool isContended(int addr) const
+    {
+        return (bankFlags[pageOf(addr)] & Contended) != 0;
     }
 
   private:
-    class ScreenBus : public IBus
+    static int pageOf(int addr)
+    {
+        return PageMap::pageOf(addr);
+    }
+
+    void map(int page, const std::uint8_t* readPage, std::uint8_t* writePage, std::uint8_t flags)
     {
-      public:
-        ScreenBus(const ByteSpan span) : span(span)
+        pages.readPages[page] = readPage;
+        pages.writePages[page] = writePage;
+        bankFlags[page] = flags;
+        updateFlags(page);
+    }
+
+    void updateFlags(int page)
+    {
+        const auto watched = [this, page](int kind) { return (watchFlags[page] & kind) != 0 ? Watched : 0; };
+
+        pages.readFlags[page] = bankFlags[page] | watched(WatchRead);
+        pages.writeFlags[page] =
+            bankFlags[page] | watched(WatchWrite) | (pages.writePages[page] == screenMemory() ? Display : 0);
+        pages.fetchFlags[page] = bankFlags[page] | watched(WatchExecute);
+    }
+
+    void page(int value)
+    {
+        paging = value;
+        locked = (value & pagingLock) != 0;
+        remap();
+    }
+
+    void remap()
+    {
+        if (Model::plus3Paging && (plus3 & plus3Special) != 0)
         {
+            const auto& banks = specialBanks[(plus3 >> 1) & 3];
+            for (int page = 0; page < pageCount; page++)
+            {
+                mapBank(page, banks[page]);
+            }
+        }
+        else
+        {
+            map(0, rom->page(romPage()), storage->discard.data(), 0);
+            mapBank(1, normalScreenBank);
+            mapBank(2, 2);
+            mapBank(3, paging & pagingBankMask);
         }
 
-        ScreenBus(const ScreenBus&) = delete;
+        // The shadow screen bit moves the display between banks.
+        for (int page = 0; page < pageCount; page++)
+        {
+            updateFlags(page);
+        }
+    }
 
-        int read(int addr) const final override
+    int romPage() const
+    {
+        const int low = (paging & pagingRom) != 0 ? 1 : 0;
+        return Model::plus3Paging && (plus3 & plus3RomHigh) != 0 ? low | 2 : low;
+    }
+
+    void screenMoved(const std::uint8_t* shown, int cycle)
+    {
+        if (screenMemory() != shown)
         {
-            return span[addr];
+            screenCtrl.setScreenMemory(screenMemory(), cycle);
         }
+    }
+
+    void mapBank(int page, int bank)
+    {
+        const std::uint8_t flags = contended && ((Model::contendedBanks >> bank) & 1) != 0 ? Contended : 0;
+        map(page, bankMemory(bank), bankMemory(bank), flags);
+    }
+
+    // Storage slot of a 128K bank number; see ramBanks.
+    std::uint8_t* bankMemory(int bank) const
+    {
+        if constexpr (Model::paging)
+        {
+            return storage->ram[bank].data();
+        }
+        else
+        {
+            return storage->ram[bank == normalScreenBank ? 0 : bank == 2 ? 1 : 2].data();
+        }
+    }
 
-        void write(int addr, int data) final override
+    // Contention is looked up at the tstate of the access itself, cycle
+    // tstates into the instruction.
+    void trap(int page, int addr, WatchKind kind, int cycle) const
+    {
+        if constexpr (contended)
+        {
+            if ((bankFlags[page] & Contended) != 0)
+            {
+                clock.advance(Contention<Model>::memory(clock.now() + cycle));
+            }
+        }
+        if ((pages.writeFlags[page] & Display) != 0 && kind == WatchWrite && (addr & pageMask) < screenSize)
         {
+            screenCtrl.beforeScreenWrite(addr & pageMask, cycle);
         }
+        if ((watchFlags[page] & kind) != 0)
+        {
+            watchpoints.check(kind, addr);
+        }
+    }
 
-      private:
-        ByteSpan span;
+    struct Storage
+    {
+        std::array<Page, ramBanks> ram;
+        Page discard;
     };
 
-    std::array<std::uint8_t, romSize> rom;
-    std::array<std::uint8_t, ramSize> ram;
-    ScreenBus screenBus_;
+    PageMap pages;
+    std::array<std::uint8_t, pageCount> bankFlags;
+    std::array<std::uint8_t, pageCount> watchFlags;
+    Scheduler& clock;
+    IScreenCtrl& screenCtrl;
+    Watchpoints& watchpoints;
+    int paging;
+    int plus3;
+    bool locked;
+    RomImage::Ptr rom;
+    std::unique_ptr<Storage> storage;
 };
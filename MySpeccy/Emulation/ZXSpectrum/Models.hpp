@@ -0,0 +1,168 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include "Interfaces/API.hpp"
+
+#include <array>
+#include <cstdint>
+
+// Compile-time description of each machine. Screen, the ULA tables,
+// Memory, IOBus and Machine are instantiated per model, so timing
+// arithmetic folds to constants in every hot path. Only the TC2048 has
+// the Timex SCLD, so on the others its port and second display file cost
+// nothing. Port 0x7FFD answers where (addr & pagingPortMask) == pagingPort,
+// and on the +2A port 0x1FFD likewise with the plus3 pair.
+
+struct Model48K
+{
+    static constexpr MachineModel model{MachineModel::ZX48K};
+
+    static constexpr int cpuClock{3500000};
+    static constexpr int totalLineCycles{224};
+    static constexpr int totalFrameCycles{70000};
+    static constexpr int cyclesToFirstByte{14336};
+    static constexpr int intLength{32};
+
+    static constexpr bool contended{true};
+    static constexpr bool ioContended{true};
+    static constexpr int contentionStart{cyclesToFirstByte - 1};
+    static constexpr std::array<std::uint8_t, 8> contentionPattern{6, 5, 4, 3, 2, 1, 0, 0};
+    static constexpr std::uint8_t contendedBanks{0b10101010};
+
+    static constexpr bool paging{false};
+    static constexpr int pagingPortMask{0};
+    static constexpr int pagingPort{0};
+    static constexpr bool plus3Paging{false};
+    static constexpr int plus3PortMask{0};
+    static constexpr int plus3Port{0};
+    static constexpr bool floatingBus{true};
+    static constexpr bool timexScreen{false};
+    static constexpr bool ay{false};
+};
+
+struct Model128K
+{
+    static constexpr MachineModel model{MachineModel::ZX128K};
+
+    static constexpr int cpuClock{3546900};
+    static constexpr int totalLineCycles{228};
+    static constexpr int totalFrameCycles{70908};
+    static constexpr int cyclesToFirstByte{14364};
+    static constexpr int intLength{36};
+
+    static constexpr bool contended{true};
+    static constexpr bool ioContended{true};
+    static constexpr int contentionStart{cyclesToFirstByte - 3};
+    static constexpr std::array<std::uint8_t, 8> contentionPattern{6, 5, 4, 3, 2, 1, 0, 0};
+    static constexpr std::uint8_t contendedBanks{0b10101010};
+
+    static constexpr bool paging{true};
+    static constexpr int pagingPortMask{0x8002};
+    static constexpr int pagingPort{0};
+    static constexpr bool plus3Paging{false};
+    static constexpr int plus3PortMask{0};
+    static constexpr int plus3Port{0};
+    static constexpr bool floatingBus{true};
+    static constexpr bool timexScreen{false};
+    static constexpr bool ay{true};
+};
+
+// The gate array contends banks 4-7 with its own pattern and leaves
+// I/O uncontended. It decodes A12 and A14 as well as the 128K, so 0x7FFD
+// and 0x1FFD, which adds a ROM bit and all-RAM maps, stay apart.
+struct ModelPlus2A
+{
+    static constexpr MachineModel model{MachineModel::ZXPlus2A};
+
+    static constexpr int cpuClock{3546900};
+    static constexpr int totalLineCycles{228};
+    static constexpr int totalFrameCycles{70908};
+    static constexpr int cyclesToFirstByte{14365};
+    static constexpr int intLength{32};
+
+    static constexpr bool contended{true};
+    static constexpr bool ioContended{false};
+    static constexpr int contentionStart{cyclesToFirstByte - 1};
+    static constexpr std::array<std::uint8_t, 8> contentionPattern{1, 0, 7, 6, 5, 4, 3, 2};
+    static constexpr std::uint8_t contendedBanks{0b11110000};
+
+    static constexpr bool paging{true};
+    static constexpr int pagingPortMask{0xC002};
+    static constexpr int pagingPort{0x4000};
+    static constexpr bool plus3Paging{true};
+    static constexpr int plus3PortMask{0xF002};
+    static constexpr int plus3Port{0x1000};
+    static constexpr bool floatingBus{false};
+    static constexpr bool timexScreen{false};
+    static constexpr bool ay{true};
+};
+
+// The 48K's timings, with the SCLD's display modes on port 0xFF. The SCLD
+// answers reads of its own port and leaves the others at 0xFF.
+struct ModelTC2048
+{
+    static constexpr MachineModel model{MachineModel::TC2048};
+
+    static constexpr int cpuClock{3500000};
+    static constexpr int totalLineCycles{224};
+    static constexpr int totalFrameCycles{70000};
+    static constexpr int cyclesToFirstByte{14336};
+    static constexpr int intLength{32};
+
+    static constexpr bool contended{true};
+    static constexpr bool ioContended{true};
+    static constexpr int contentionStart{cyclesToFirstByte - 1};
+    static constexpr std::array<std::uint8_t, 8> contentionPattern{6, 5, 4, 3, 2, 1, 0, 0};
+    static constexpr std::uint8_t contendedBanks{0b10101010};
+
+    static constexpr bool paging{false};
+    static constexpr int pagingPortMask{0};
+    static constexpr int pagingPort{0};
+    static constexpr bool plus3Paging{false};
+    static constexpr int plus3PortMask{0};
+    static constexpr int plus3Port{0};
+    static constexpr bool floatingBus{false};
+    static constexpr bool timexScreen{true};
+    static constexpr bool ay{false};
+};
+
+struct ModelPentagon
+{
+    static constexpr MachineModel model{MachineModel::Pentagon};
+
+    static constexpr int cpuClock{3500000};
+    static constexpr int totalLineCycles{224};
+    static constexpr int totalFrameCycles{71680};
+    static constexpr int cyclesToFirstByte{17988};
+    static constexpr int intLength{36};
+
+    static constexpr bool contended{false};
+    static constexpr bool ioContended{false};
+    static constexpr int contentionStart{0};
+    static constexpr std::array<std::uint8_t, 8> contentionPattern{};
+    static constexpr std::uint8_t contendedBanks{0};
+
+    static constexpr bool paging{true};
+    static constexpr int pagingPortMask{0x8002};
+    static constexpr int pagingPort{0};
+    static constexpr bool plus3Paging{false};
+    static constexpr int plus3PortMask{0};
+    static constexpr int plus3Port{0};
+    static constexpr bool floatingBus{false};
+    static constexpr bool timexScreen{false};
+    static constexpr bool ay{true};
+};
@@ -0,0 +1,181 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "ZXSpectrum/PixelFormats.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OCTET_RENDERER_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OCTET_RENDERER_NEON 1
+#endif
+
+// Turns one bitmap byte and one attribute byte into eight pixels. All the
+// colour arithmetic is done up front: an attribute maps to an ink/paper
+// pair for each flash phase and a bitmap byte maps to eight lane masks,
+// so an octet is a single masked select, 64 to 256 bits wide depending
+// on the pixel size.
+template <typename Format> class OctetRenderer
+{
+  public:
+    using Pixel = typename Format::Pixel;
+
+    struct Colors
+    {
+        Pixel ink;
+        Pixel paper;
+    };
+
+    using Lanes = std::array<Pixel, 8>;
+
+    // Index with [flash][attribute]; flash phase 1 swaps ink and paper
+    // for attributes with the FLASH bit set.
+    using AttributeTable = std::array<std::array<Colors, 256>, 2>;
+    using MaskTable = std::array<Lanes, 256>;
+
+    static const AttributeTable attributes;
+    static const MaskTable masks;
+
+    static constexpr Pixel borderColor(int index)
+    {
+        return Format::color(index & 7, false);
+    }
+
+    static constexpr Colors makeColors(int attr, int flash)
+    {
+        const bool bright = (attr & 0x40) != 0;
+        const Pixel ink = Format::color(attr & 7, bright);
+        const Pixel paper = Format::color((attr >> 3) & 7, bright);
+
+        if (flash && (attr & 0x80))
+        {
+            return {paper, ink};
+        }
+        return {ink, paper};
+    }
+
+    static void draw(Pixel* out, std::uint8_t bits, Colors colors)
+    {
+        const Pixel* mask = masks[bits].data();
+#if defined(OCTET_RENDERER_SSE2)
+        const __m128i ink = broadcast(colors.ink);
+        const __m128i paper = broadcast(colors.paper);
+        if constexpr (sizeof(Lanes) == 8)
+        {
+            const __m128i select = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), blend(select, ink, paper));
+        }
+        else
+        {
+            for (std::size_t i = 0; i < Lanes{}.size(); i += 16 / sizeof(Pixel))
+            {
+                const __m128i select = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), blend(select, ink, paper));
+            }
+        }
+#elif defined(OCTET_RENDERER_NEON)
+        if constexpr (sizeof(Pixel) == 1)
+        {
+            vst1_u8(out, vbsl_u8(vld1_u8(mask), vdup_n_u8(colors.ink), vdup_n_u8(colors.paper)));
+        }
+        else if constexpr (sizeof(Pixel) == 2)
+        {
+            vst1q_u16(out, vbslq_u16(vld1q_u16(mask), vdupq_n_u16(colors.ink), vdupq_n_u16(colors.paper)));
+        }
+        else
+        {
+            const uint32x4_t ink = vdupq_n_u32(colors.ink);
+            const uint32x4_t paper = vdupq_n_u32(colors.paper);
+            vst1q_u32(out, vbslq_u32(vld1q_u32(mask), ink, paper));
+            vst1q_u32(out + 4, vbslq_u32(vld1q_u32(mask + 4), ink, paper));
+        }
+#else
+        for (int i = 0; i < 8; i++)
+        {
+            out[i] = (colors.ink & mask[i]) | (colors.paper & ~mask[i]);
+        }
+#endif
+    }
+
+    static void fill(Pixel* out, Pixel color)
+    {
+        draw(out, 0, {color, color});
+    }
+
+  private:
+#if defined(OCTET_RENDERER_SSE2)
+    static __m128i broadcast(Pixel pixel)
+    {
+        if constexpr (sizeof(Pixel) == 1)
+        {
+            return _mm_set1_epi8(static_cast<char>(pixel));
+        }
+        else if constexpr (sizeof(Pixel) == 2)
+        {
+            return _mm_set1_epi16(static_cast<short>(pixel));
+        }
+        else
+        {
+            return _mm_set1_epi32(static_cast<int>(pixel));
+        }
+    }
+
+    static __m128i blend(__m128i select, __m128i ink, __m128i paper)
+    {
+        return _mm_or_si128(_mm_and_si128(select, ink), _mm_andnot_si128(select, paper));
+    }
+#endif
+
+    static constexpr AttributeTable makeAttributes()
+    {
+        AttributeTable table{};
+        for (int flash = 0; flash < 2; flash++)
+        {
+            for (int attr = 0; attr < 256; attr++)
+            {
+                table[flash][attr] = makeColors(attr, flash);
+            }
+        }
+        return table;
+    }
+
+    static constexpr MaskTable makeMasks()
+    {
+        MaskTable table{};
+        for (int bits = 0; bits < 256; bits++)
+        {
+            for (int i = 0; i < 8; i++)
+            {
+                table[bits][i] = (bits & (0x80 >> i)) ? Pixel(~Pixel{0}) : Pixel{0};
+            }
+        }
+        return table;
+    }
+};
+
+template <typename Format>
+inline constexpr typename OctetRenderer<Format>::AttributeTable OctetRenderer<Format>::attributes{
+    OctetRenderer<Format>::makeAttributes()};
+
+template <typename Format>
+inline constexpr typename OctetRenderer<Format>::MaskTable OctetRenderer<Format>::masks{
+    OctetRenderer<Format>::makeMasks()};
@@ -0,0 +1,132 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include "Interfaces/API.hpp"
+
+#include <cstdint>
+
+// Output pixel formats Screen can render into directly. Each one turns a
+// Spectrum colour index (bit 0 blue, bit 1 red, bit 2 green) and the
+// BRIGHT flag into a ready-to-upload pixel. RGB formats also take any
+// 8-bit RGB colour, and give the lowest bit of every channel for
+// averaging whole pixels at once.
+
+struct RgbFormat
+{
+    // Non-bright colours sit at 21/31 of full intensity.
+    static constexpr int level(int max, bool bright)
+    {
+        return bright ? max : (max * 21 + 15) / 31;
+    }
+
+    static constexpr int channel(int index, int bit, int max, bool bright)
+    {
+        return (index & bit) != 0 ? level(max, bright) : 0;
+    }
+};
+
+// x1R5G5B5, blue in the low bits.
+struct Rgb555 : RgbFormat
+{
+    using Pixel = std::uint16_t;
+
+    static constexpr PixelFormat format{PixelFormat::RGB555};
+    static constexpr Pixel lowBits{0x0421};
+
+    static constexpr Pixel color(int index, bool bright)
+    {
+        return Pixel(channel(index, 2, 31, bright) << 10 | channel(index, 4, 31, bright) << 5 |
+                     channel(index, 1, 31, bright));
+    }
+
+    static constexpr Pixel rgb(int red, int green, int blue)
+    {
+        return Pixel((red >> 3) << 10 | (green >> 3) << 5 | blue >> 3);
+    }
+};
+
+struct Rgb565 : RgbFormat
+{
+    using Pixel = std::uint16_t;
+
+    static constexpr PixelFormat format{PixelFormat::RGB565};
+    static constexpr Pixel lowBits{0x0821};
+
+    static constexpr Pixel color(int index, bool bright)
+    {
+        return Pixel(channel(index, 2, 31, bright) << 11 | channel(index, 4, 63, bright) << 5 |
+                     channel(index, 1, 31, bright));
+    }
+
+    static constexpr Pixel rgb(int red, int green, int blue)
+    {
+        return Pixel((red >> 3) << 11 | (green >> 2) << 5 | blue >> 3);
+    }
+};
+
+// Byte order R, G, B, A in memory.
+struct Rgba8888 : RgbFormat
+{
+    using Pixel = std::uint32_t;
+
+    static constexpr PixelFormat format{PixelFormat::RGBA8888};
+    static constexpr Pixel lowBits{0x01010101};
+
+    static constexpr Pixel color(int index, bool bright)
+    {
+        return Pixel(0xFF) << 24 | Pixel(channel(index, 1, 255, bright)) << 16 |
+               Pixel(channel(index, 4, 255, bright)) << 8 | Pixel(channel(index, 2, 255, bright));
+    }
+
+    static constexpr Pixel rgb(int red, int green, int blue)
+    {
+        return Pixel(0xFF) << 24 | Pixel(blue) << 16 | Pixel(green) << 8 | Pixel(red);
+    }
+};
+
+// Byte order B, G, R, A in memory.
+struct Bgra8888 : RgbFormat
+{
+    using Pixel = std::uint32_t;
+
+    static constexpr PixelFormat format{PixelFormat::BGRA8888};
+    static constexpr Pixel lowBits{0x01010101};
+
+    static constexpr Pixel color(int index, bool bright)
+    {
+        return Pixel(0xFF) << 24 | Pixel(channel(index, 2, 255, bright)) << 16 |
+               Pixel(channel(index, 4, 255, bright)) << 8 | Pixel(channel(index, 1, 255, bright));
+    }
+
+    static constexpr Pixel rgb(int red, int green, int blue)
+    {
+        return Pixel(0xFF) << 24 | Pixel(red) << 16 | Pixel(green) << 8 | Pixel(blue);
+    }
+};
+
+// Palette index: colours 0-7, plus 8 when bright.
+struct Indexed8
+{
+    using Pixel = std::uint8_t;
+
+    static constexpr PixelFormat format{PixelFormat::Indexed8};
+
+    static constexpr Pixel color(int index, bool bright)
+    {
+        return Pixel((index & 7) | (bright ? 8 : 0));
+    }
+};
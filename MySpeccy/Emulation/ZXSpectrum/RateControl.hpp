@@ -0,0 +1,55 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+// Keeps an audio ring near its target fill while emulation follows the
+// display rather than the sound card. Each frame it turns the ring's fill
+// into a factor for the resampling ratio, proportional to how far off the
+// target it is and never more than maxAdjust: small enough that nobody
+// hears the pitch move. The fill is smoothed first, since the callback
+// drains in bursts and one reading says little.
+class RateControl
+{
+  public:
+    static constexpr double maxAdjust{0.005};
+    static constexpr double smoothing{0.05};
+
+    RateControl() : average{-1.0}
+    {
+    }
+
+    RateControl(const RateControl&) = delete;
+
+    void reset()
+    {
+        average = -1.0;
+    }
+
+    // Factor for input samples per output sample: above one makes fewer
+    // samples, for a ring that is too full.
+    double update(std::size_t fill, std::size_t target)
+    {
+        average = average < 0.0 ? double(fill) : average + (double(fill) - average) * smoothing;
+        const double error = std::clamp((average - double(target)) / double(target), -1.0, 1.0);
+        return 1.0 + maxAdjust * error;
+    }
+
+  private:
+    double average;
+};
@@ -0,0 +1,344 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include "Interfaces/API.hpp"
+#include "Interfaces/IBorderCtrl.hpp"
+#include "Interfaces/IDisplayModeCtrl.hpp"
+#include "Interfaces/IScreenCtrl.hpp"
+#include "ZXSpectrum/Scheduler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <vector>
+
+// Moves pixel work off the emulation thread. The emulator only logs what
+// the beam could see change during a frame: screen writes, border changes,
+// bank switches and video mode or palette changes, each with its tstate,
+// on top of a snapshot of the displayed screen taken at frame start. A
+// worker replays the log into a Screen driven by its own clock, so the
+// picture is the same as when rendering inline, one frame later.
+//
+// Each side owns one of two logs. They are swapped at the end of a frame
+// once the worker is idle, so the logs themselves need no locking.
+template <typename Screen>
+class RenderThread final : public IBorderCtrl, public IScreenCtrl, public IDisplayModeCtrl
+{
+  public:
+    using Pixel = typename Screen::Pixel;
+
+    static constexpr std::size_t screenSize{Screen::displaySize};
+
+    // The screen is only touched from the worker, and only after the first
+    // endFrame(), so it may be constructed after this object.
+    RenderThread(const Scheduler& clock, Screen& screen)
+        : clock{clock}, screen{screen}, source{nullptr}, pendingOffset{noPending}, pendingCycles{0}, recording{0},
+          frame{nullptr}, attached{false}, state{Idle}, vram{}, worker{[this] { run(); }}
+    {
+    }
+
+    RenderThread(const RenderThread&) = delete;
+
+    ~RenderThread()
+    {
+        waitIdle();
+        state.store(Stop, std::memory_order_release);
+        state.notify_one();
+        worker.join();
+    }
+
+    // Clock the worker's Screen renders against.
+    const Scheduler& replayClock() const
+    {
+        return replay;
+    }
+
+    void setBorder(int border, int cycle) final override
+    {
+        flush();
+        log().entries.push_back({clock.now() + cycle, 0, Border, std::uint8_t(border & 7)});
+    }
+
+    // Only a switch to the other bank is logged; each one costs a copy.
+    void setScreenMemory(const std::uint8_t* screen, int cycle) final override
+    {
+        if (screen == source)
+        {
+            return;
+        }
+        flush();
+        source = screen;
+
+        Log& current = log();
+        const auto index = static_cast<std::uint16_t>(current.banks.size());
+        current.banks.emplace_back();
+        std::copy_n(source, screenSize, current.banks.back().begin());
+        current.entries.push_back({clock.now() + cycle, index, Bank, 0});
+    }
+
+    void setTimexMode(int value, int cycle) final override
+    {
+        flush();
+        log().entries.push_back({clock.now() + cycle, 0, Timex, std::uint8_t(value)});
+    }
+
+    void setPaletteEntry(int index, int value, int cycle) final override
+    {
+        flush();
+        log().entries.push_back({clock.now() + cycle, std::uint16_t(index), Palette, std::uint8_t(value)});
+    }
+
+    void setPaletteEnabled(bool enabled, int cycle) final override
+    {
+        flush();
+        log().entries.push_back({clock.now() + cycle, 0, PaletteMode, std::uint8_t(enabled)});
+    }
+
+    // The value is picked up on the next call, once the write has landed.
+    void beforeScreenWrite(int offset, int cycle) final override
+    {
+        if (source == nullptr)
+        {
+            return;
+        }
+        flush();
+        pendingOffset = offset;
+        pendingCycles = clock.now() + cycle;
+    }
+
+    // Called at the end of the frame, before the clock is rebased. Waits
+    // for the previous frame to finish rendering, hands this one over and
+    // starts logging the next.
+    void endFrame()
+    {
+        flush();
+        log().endCycles = clock.now();
+
+        waitIdle();
+        collect();
+
+        recording ^= 1;
+        state.store(Busy, std::memory_order_release);
+        state.notify_one();
+
+        Log& next = log();
+        next.entries.clear();
+        next.banks.clear();
+        if (source != nullptr)
+        {
+            std::copy_n(source, screenSize, next.snapshot.begin());
+        }
+    }
+
+    // The last frame the worker completed, held until the next endFrame().
+    const Pixel* pixels() const
+    {
+        return frame;
+    }
+
+    std::span<const DirtyRect> dirtyRects() const
+    {
+        return rects;
+    }
+
+  private:
+    enum State : int
+    {
+        Idle,
+        Busy,
+        Stop
+    };
+
+    enum Kind : std::uint8_t
+    {
+        Write,
+        Border,
+        Bank,
+        Timex,
+        Palette,
+        PaletteMode
+    };
+
+    struct Entry
+    {
+        int cycles;
+        std::uint16_t offset;
+        Kind kind;
+        std::uint8_t value;
+    };
+
+    using Memory = std::array<std::uint8_t, screenSize>;
+
+    struct Log
+    {
+        Memory snapshot{};
+        std::vector<Entry> entries;
+        std::vector<Memory> banks;
+        int endCycles{0};
+    };
+
+    static constexpr int noPending{-1};
+
+    Log& log()
+    {
+        return logs[recording];
+    }
+
+    void flush()
+    {
+        if (pendingOffset != noPending)
+        {
+            log().entries.push_back({pendingCycles, std::uint16_t(pendingOffset), Write, source[pendingOffset]});
+            pendingOffset = noPending;
+        }
+    }
+
+    void waitIdle()
+    {
+        State current;
+        while ((current = state.load(std::memory_order_acquire)) == Busy)
+        {
+            state.wait(current, std::memory_order_acquire);
+        }
+    }
+
+    // Runs while the worker is idle, so the screen is safe to read.
+    void collect()
+    {
+        if (const Pixel* finished = screen.acquireFrame())
+        {
+            frame = finished;
+            const auto finishedRects = screen.dirtyRects();
+            rects.assign(finishedRects.begin(), finishedRects.end());
+        }
+        else
+        {
+            rects.clear();
+        }
+    }
+
+    void run()
+    {
+        while (true)
+        {
+            state.wait(Idle, std::memory_order_acquire);
+            const State current = state.load(std::memory_order_acquire);
+            if (current == Stop)
+            {
+                return;
+            }
+            if (current == Busy)
+            {
+                render(logs[recording ^ 1]);
+                state.store(Idle, std::memory_order_release);
+                state.notify_one();
+            }
+        }
+    }
+
+    void render(const Log& frameLog)
+    {
+        if (!attached)
+        {
+            screen.setScreenMemory(vram.data(), 0);
+            attached = true;
+        }
+
+        load(frameLog.snapshot);
+
+        for (const Entry& entry : frameLog.entries)
+        {
+            advanceTo(entry.cycles);
+            switch (entry.kind)
+            {
+            case Write:
+                screen.beforeScreenWrite(entry.offset, 0);
+                vram[entry.offset] = entry.value;
+                break;
+
+            case Border:
+                screen.setBorder(entry.value, 0);
+                break;
+
+            case Bank:
+                load(frameLog.banks[entry.offset]);
+                break;
+
+            case Timex:
+                screen.setTimexMode(entry.value, 0);
+                break;
+
+            case Palette:
+                screen.setPaletteEntry(entry.offset, entry.value, 0);
+                break;
+
+            case PaletteMode:
+                screen.setPaletteEnabled(entry.value != 0, 0);
+                break;
+            }
+        }
+
+        advanceTo(frameLog.endCycles);
+        screen.catchUp();
+        replay.rebase(Screen::totalFrameCycles);
+        screen.newFrame(replay.now());
+    }
+
+    // Brings the worker's copy of the screen in line with a snapshot,
+    // going through the Screen so changed cells are marked.
+    void load(const Memory& content)
+    {
+        for (std::size_t offset = 0; offset < screenSize; offset++)
+        {
+            if (vram[offset] != content[offset])
+            {
+                screen.beforeScreenWrite(static_cast<int>(offset), 0);
+                vram[offset] = content[offset];
+            }
+        }
+    }
+
+    void advanceTo(int cycles)
+    {
+        if (cycles > replay.now())
+        {
+            replay.advance(cycles - replay.now());
+        }
+    }
+
+    // Emulation thread.
+    const Scheduler& clock;
+    Screen& screen;
+    const std::uint8_t* source;
+    int pendingOffset;
+    int pendingCycles;
+    int recording;
+    std::array<Log, 2> logs;
+    const Pixel* frame;
+    std::vector<DirtyRect> rects;
+
+    // Worker thread.
+    bool attached;
+    Scheduler replay;
+
+    std::atomic<State> state;
+    Memory vram;
+    std::thread worker;
+};
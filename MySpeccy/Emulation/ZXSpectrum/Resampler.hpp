@@ -0,0 +1,222 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RESAMPLER_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RESAMPLER_NEON 1
+#endif
+
+// Converts interleaved stereo from the internal rate to the host's. Each
+// output sample is a windowed-sinc low-pass evaluated at its fractional
+// input position: the filter is kept as phases + 1 rows of taps and the
+// result interpolated between the two rows either side. The ratio can
+// change every call; the filter is only redesigned when it moves by more
+// than the rate control would ever ask for.
+class Resampler
+{
+  public:
+    static constexpr int defaultOutputRate{44100};
+    static constexpr int phases{32};
+
+    // Input frames kept for a caller that pulls less than it pushes.
+    static constexpr std::size_t maxQueued{1 << 15};
+
+    Resampler() : step{0.0}, designed{0.0}, taps{0}, position{0.0}
+    {
+    }
+
+    Resampler(const Resampler&) = delete;
+
+    // Input samples per output sample.
+    void setRatio(double ratio)
+    {
+        step = ratio;
+        if (designed == 0.0 || std::abs(ratio / designed - 1.0) > 0.01)
+        {
+            design(ratio);
+        }
+    }
+
+    double ratio() const
+    {
+        return step;
+    }
+
+    void push(const float* samples, std::size_t count)
+    {
+        input.insert(input.end(), samples, samples + 2 * count);
+        const std::size_t frames = input.size() / 2;
+        if (frames > maxQueued)
+        {
+            drop(frames - maxQueued);
+        }
+    }
+
+    // Writes up to capacity samples, mixed to mono or interleaved; input
+    // that is not used yet stays for the next call.
+    std::uint32_t pull(float* out, std::uint32_t capacity, bool stereo)
+    {
+        std::uint32_t count = 0;
+        for (; out && count < capacity; count++)
+        {
+            const auto index = std::size_t(position);
+            if (2 * (index + taps) > input.size())
+            {
+                break;
+            }
+
+            const double phase = (position - double(index)) * phases;
+            const int row = int(phase);
+            const float weight = float(phase - row);
+            const float* rows = filter.data() + std::size_t(row) * 2 * taps;
+            const auto sums = dot(input.data() + 2 * index, rows, rows + 2 * taps, 2 * taps);
+            const float left = sums[0] + (sums[2] - sums[0]) * weight;
+            const float right = sums[1] + (sums[3] - sums[1]) * weight;
+
+            if (stereo)
+            {
+                out[2 * count] = left;
+                out[2 * count + 1] = right;
+            }
+            else
+            {
+                out[count] = (left + right) * 0.5f;
+            }
+            position += step;
+        }
+        drop(std::min(std::size_t(position), input.size() / 2));
+        return count;
+    }
+
+    // Left and right sums of in times two rows of coefficients at once,
+    // the first row's pair then the second's. count is a multiple of
+    // eight; each coefficient is stored twice to match the interleaved
+    // input.
+    static std::array<float, 4> dot(const float* in, const float* first, const float* second, int count)
+    {
+#if defined(RESAMPLER_SSE2)
+        __m128 a0 = _mm_setzero_ps();
+        __m128 a1 = _mm_setzero_ps();
+        __m128 b0 = _mm_setzero_ps();
+        __m128 b1 = _mm_setzero_ps();
+        for (int i = 0; i < count; i += 8)
+        {
+            const __m128 x0 = _mm_loadu_ps(in + i);
+            const __m128 x1 = _mm_loadu_ps(in + i + 4);
+            a0 = _mm_add_ps(a0, _mm_mul_ps(x0, _mm_loadu_ps(first + i)));
+            a1 = _mm_add_ps(a1, _mm_mul_ps(x1, _mm_loadu_ps(first + i + 4)));
+            b0 = _mm_add_ps(b0, _mm_mul_ps(x0, _mm_loadu_ps(second + i)));
+            b1 = _mm_add_ps(b1, _mm_mul_ps(x1, _mm_loadu_ps(second + i + 4)));
+        }
+        // Lanes are left, right, left, right: fold the top half down.
+        __m128 a = _mm_add_ps(a0, a1);
+        __m128 b = _mm_add_ps(b0, b1);
+        a = _mm_add_ps(a, _mm_movehl_ps(a, a));
+        b = _mm_add_ps(b, _mm_movehl_ps(b, b));
+        alignas(16) std::array<float, 4> sums;
+        _mm_store_ps(sums.data(), _mm_movelh_ps(a, b));
+        return sums;
+#elif defined(RESAMPLER_NEON)
+        float32x4_t a0 = vdupq_n_f32(0.0f);
+        float32x4_t a1 = vdupq_n_f32(0.0f);
+        float32x4_t b0 = vdupq_n_f32(0.0f);
+        float32x4_t b1 = vdupq_n_f32(0.0f);
+        for (int i = 0; i < count; i += 8)
+        {
+            const float32x4_t x0 = vld1q_f32(in + i);
+            const float32x4_t x1 = vld1q_f32(in + i + 4);
+            a0 = vmlaq_f32(a0, x0, vld1q_f32(first + i));
+            a1 = vmlaq_f32(a1, x1, vld1q_f32(first + i + 4));
+            b0 = vmlaq_f32(b0, x0, vld1q_f32(second + i));
+            b1 = vmlaq_f32(b1, x1, vld1q_f32(second + i + 4));
+        }
+        const float32x4_t a = vaddq_f32(a0, a1);
+        const float32x4_t b = vaddq_f32(b0, b1);
+        const float32x4_t sums = vcombine_f32(vadd_f32(vget_low_f32(a), vget_high_f32(a)),
+                                              vadd_f32(vget_low_f32(b), vget_high_f32(b)));
+        std::array<float, 4> result;
+        vst1q_f32(result.data(), sums);
+        return result;
+#else
+        std::array<float, 4> sums{};
+        for (int i = 0; i < count; i += 2)
+        {
+            sums[0] += in[i] * first[i];
+            sums[1] += in[i + 1] * first[i + 1];
+            sums[2] += in[i] * second[i];
+            sums[3] += in[i + 1] * second[i + 1];
+        }
+        return sums;
+#endif
+    }
+
+  private:
+    void drop(std::size_t frames)
+    {
+        input.erase(input.begin(), input.begin() + 2 * frames);
+        position = std::max(0.0, position - double(frames));
+    }
+
+    // Blackman-windowed sinc cut off at 90% of the output Nyquist, 32
+    // output samples wide, each row scaled to sum to one.
+    void design(double ratio)
+    {
+        designed = ratio;
+        const double stretch = std::max(1.0, ratio);
+        taps = 4 * int(std::ceil(8 * stretch));
+        const double cutoff = 0.9 / stretch;
+        constexpr double pi = std::numbers::pi;
+
+        filter.assign(std::size_t(phases + 1) * 2 * taps, 0.0f);
+        std::vector<double> values(taps);
+        for (int row = 0; row <= phases; row++)
+        {
+            double sum = 0.0;
+            for (int i = 0; i < taps; i++)
+            {
+                const double x = i - (taps / 2 - 1) - double(row) / phases;
+                const double u = (x + taps / 2) / taps;
+                const double window = 0.42 - 0.5 * std::cos(2 * pi * u) + 0.08 * std::cos(4 * pi * u);
+                values[i] = (x == 0.0 ? 1.0 : std::sin(pi * cutoff * x) / (pi * cutoff * x)) * window;
+                sum += values[i];
+            }
+            float* coefficients = filter.data() + std::size_t(row) * 2 * taps;
+            for (int i = 0; i < taps; i++)
+            {
+                coefficients[2 * i] = coefficients[2 * i + 1] = float(values[i] / sum);
+            }
+        }
+    }
+
+    double step;
+    double designed;
+    int taps;
+    double position;
+    std::vector<float> filter;
+    std::vector<float> input;
+};
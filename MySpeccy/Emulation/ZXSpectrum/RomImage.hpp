@@ -0,0 +1,132 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+// Immutable ROM content shared by every Machine that loads the same
+// bytes. Instances only hold a reference, so thousands of machines
+// cost one copy of each distinct ROM.
+class RomImage
+{
+  public:
+    static constexpr std::size_t pageSize{0x4000};
+    // The +2A has four ROMs; the 128K uses the first two.
+    static constexpr std::size_t pageCount{4};
+
+    using Page = std::array<std::uint8_t, pageSize>;
+    using Ptr = std::shared_ptr<const RomImage>;
+
+    RomImage(const RomImage&) = delete;
+
+    // Missing bytes are zero; anything beyond pageCount pages is ignored.
+    static Ptr intern(std::span<const std::uint8_t> content)
+    {
+        content = content.first(std::min(content.size(), pageSize * pageCount));
+
+        auto& registry = Registry::instance();
+        std::lock_guard lock{registry.mutex};
+
+        auto& bucket = registry.images[hash(content)];
+        std::erase_if(bucket, [](const auto& image) { return image.expired(); });
+        for (const auto& weak : bucket)
+        {
+            auto image = weak.lock();
+            if (image && image->matches(content))
+            {
+                return image;
+            }
+        }
+
+        Ptr image{new RomImage{content}};
+        bucket.push_back(image);
+        return image;
+    }
+
+    static Ptr blank()
+    {
+        static const Ptr image{intern({})};
+        return image;
+    }
+
+    const std::uint8_t* page(std::size_t index) const
+    {
+        return pages[index].data();
+    }
+
+  private:
+    struct Registry
+    {
+        static Registry& instance()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        std::mutex mutex;
+        std::unordered_map<std::size_t, std::vector<std::weak_ptr<const RomImage>>> images;
+    };
+
+    RomImage(std::span<const std::uint8_t> content) : pages{}, size{content.size()}
+    {
+        for (auto& page : pages)
+        {
+            const auto copySize = std::min(content.size(), page.size());
+            std::copy(content.begin(), content.begin() + copySize, page.begin());
+            content = content.subspan(copySize);
+        }
+    }
+
+    bool matches(std::span<const std::uint8_t> content) const
+    {
+        if (content.size() != size)
+        {
+            return false;
+        }
+        for (const auto& page : pages)
+        {
+            const auto compareSize = std::min(content.size(), page.size());
+            if (!std::equal(content.begin(), content.begin() + compareSize, page.begin()))
+            {
+                return false;
+            }
+            content = content.subspan(compareSize);
+        }
+        return true;
+    }
+
+    // FNV-1a
+    static std::size_t hash(std::span<const std::uint8_t> content)
+    {
+        std::uint64_t result = 0xCBF29CE484222325;
+        for (const auto byte : content)
+        {
+            result = (result ^ byte) * 0x100000001B3;
+        }
+        return static_cast<std::size_t>(result);
+    }
+
+    std::array<Page, pageCount> pages;
+    std::size_t size;
+};
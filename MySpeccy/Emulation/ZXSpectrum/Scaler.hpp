@@ -0,0 +1,431 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Interfaces/API.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SCALER_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SCALER_NEON 1
+#endif
+
+// Integer upscaling of a finished frame on the CPU, either by repeating
+// pixels or with the Scale2x/Scale3x edge rules; Scale4x is Scale2x done
+// twice. Work goes one source row at a time: the rows it reads and the
+// rows it writes are all that is in use at once, and Scale4x keeps its
+// intermediate rows in a three-row ring instead of a whole 2x frame.
+template <typename Pixel> class Scaler
+{
+  public:
+    Scaler() = default;
+    Scaler(const Scaler&) = delete;
+
+    // Strides are in pixels. The destination must hold width * factor by
+    // height * factor pixels; factors other than 2, 3 and 4 are ignored,
+    // and so is a missing source or destination.
+    void scale(const Pixel* src, std::size_t srcStride, int width, int height, Pixel* dst, std::size_t dstStride,
+               int factor, ScaleFilter filter)
+    {
+        if (src == nullptr || dst == nullptr || width <= 0 || height <= 0 || factor < 2 || factor > 4)
+        {
+            return;
+        }
+
+        if (filter == ScaleFilter::Nearest)
+        {
+            for (int y = 0; y < height; y++)
+            {
+                Pixel* out = dst + std::size_t(y) * factor * dstStride;
+                widen(src + std::size_t(y) * srcStride, width, factor, out);
+                for (int copy = 1; copy < factor; copy++)
+                {
+                    std::copy_n(out, width * factor, out + copy * dstStride);
+                }
+            }
+        }
+        else if (factor == 2)
+        {
+            for (int y = 0; y < height; y++)
+            {
+                const Pixel* row = src + std::size_t(y) * srcStride;
+                Pixel* out = dst + std::size_t(y) * 2 * dstStride;
+                scale2xRow(above(row, y, srcStride), row, below(row, y, height, srcStride), width, out,
+                           out + dstStride);
+            }
+        }
+        else if (factor == 3)
+        {
+            for (int y = 0; y < height; y++)
+            {
+                const Pixel* row = src + std::size_t(y) * srcStride;
+                Pixel* out = dst + std::size_t(y) * 3 * dstStride;
+                scale3xRow(above(row, y, srcStride), row, below(row, y, height, srcStride), width, out, dstStride);
+            }
+        }
+        else
+        {
+            scale4x(src, srcStride, width, height, dst, dstStride);
+        }
+    }
+
+  private:
+    static const Pixel* above(const Pixel* row, int y, std::size_t stride)
+    {
+        return y > 0 ? row - stride : row;
+    }
+
+    static const Pixel* below(const Pixel* row, int y, int height, std::size_t stride)
+    {
+        return y + 1 < height ? row + stride : row;
+    }
+
+    // Each source row becomes a pair of 2x rows in the ring, one row ahead
+    // of the pair being scaled again, so every 2x row is computed once.
+    void scale4x(const Pixel* src, std::size_t srcStride, int width, int height, Pixel* dst, std::size_t dstStride)
+    {
+        const int midWidth = width * 2;
+        const std::size_t pairSize = std::size_t(midWidth) * 2;
+        ring.resize(pairSize * 3);
+
+        const auto pair = [&](int y) { return ring.data() + (y % 3) * pairSize; };
+        const auto makePair = [&](int y) {
+            const Pixel* row = src + std::size_t(y) * srcStride;
+            scale2xRow(above(row, y, srcStride), row, below(row, y, height, srcStride), width, pair(y),
+                       pair(y) + midWidth);
+        };
+
+        makePair(0);
+        for (int y = 0; y < height; y++)
+        {
+            if (y + 1 < height)
+            {
+                makePair(y + 1);
+            }
+
+            const Pixel* top = pair(y);
+            const Pixel* bottom = top + midWidth;
+            const Pixel* up = y > 0 ? pair(y - 1) + midWidth : top;
+            const Pixel* down = y + 1 < height ? pair(y + 1) : bottom;
+
+            Pixel* out = dst + std::size_t(y) * 4 * dstStride;
+            scale2xRow(up, top, bottom, midWidth, out, out + dstStride);
+            scale2xRow(top, bottom, down, midWidth, out + 2 * dstStride, out + 3 * dstStride);
+        }
+    }
+
+    static void widen(const Pixel* row, int width, int factor, Pixel* out)
+    {
+        int x = 0;
+#if defined(SCALER_SSE2) || defined(SCALER_NEON)
+        if (factor == 2)
+        {
+            for (; x + lanes <= width; x += lanes)
+            {
+                const Vec v = load(row + x);
+                store(out + 2 * x, zipLo(v, v));
+                store(out + 2 * x + lanes, zipHi(v, v));
+            }
+        }
+        else if (factor == 4)
+        {
+            for (; x + lanes <= width; x += lanes)
+            {
+                const Vec v = load(row + x);
+                const Vec lo = zipLo(v, v);
+                const Vec hi = zipHi(v, v);
+                store(out + 4 * x, zipLo(lo, lo));
+                store(out + 4 * x + lanes, zipHi(lo, lo));
+                store(out + 4 * x + 2 * lanes, zipLo(hi, hi));
+                store(out + 4 * x + 3 * lanes, zipHi(hi, hi));
+            }
+        }
+#endif
+        for (; x < width; x++)
+        {
+            std::fill_n(out + x * factor, factor, row[x]);
+        }
+    }
+
+    // E is the pixel, B and H above and below it, D and F left and right.
+    // Where B == H or D == F the pixel is on no edge and is just repeated;
+    // otherwise each corner takes the side it agrees with.
+    static void scale2xRow(const Pixel* up, const Pixel* row, const Pixel* down, int width, Pixel* out0, Pixel* out1)
+    {
+        scale2xPixel(up, row, down, width, 0, out0, out1);
+        int x = 1;
+#if defined(SCALER_SSE2) || defined(SCALER_NEON)
+        for (; x + lanes < width; x += lanes)
+        {
+            const Vec b = load(up + x);
+            const Vec h = load(down + x);
+            const Vec e = load(row + x);
+            const Vec d = load(row + x - 1);
+            const Vec f = load(row + x + 1);
+
+            const Vec flat = either(eq(b, h), eq(d, f));
+            const Vec e0 = select(unless(flat, eq(d, b)), d, e);
+            const Vec e1 = select(unless(flat, eq(b, f)), f, e);
+            const Vec e2 = select(unless(flat, eq(d, h)), d, e);
+            const Vec e3 = select(unless(flat, eq(h, f)), f, e);
+
+            store(out0 + 2 * x, zipLo(e0, e1));
+            store(out0 + 2 * x + lanes, zipHi(e0, e1));
+            store(out1 + 2 * x, zipLo(e2, e3));
+            store(out1 + 2 * x + lanes, zipHi(e2, e3));
+        }
+#endif
+        for (; x < width; x++)
+        {
+            scale2xPixel(up, row, down, width, x, out0, out1);
+        }
+    }
+
+    static void scale2xPixel(const Pixel* up, const Pixel* row, const Pixel* down, int width, int x, Pixel* out0,
+                             Pixel* out1)
+    {
+        const Pixel b = up[x];
+        const Pixel h = down[x];
+        const Pixel e = row[x];
+        const Pixel d = row[std::max(x - 1, 0)];
+        const Pixel f = row[std::min(x + 1, width - 1)];
+
+        if (b != h && d != f)
+        {
+            out0[2 * x] = d == b ? d : e;
+            out0[2 * x + 1] = b == f ? f : e;
+            out1[2 * x] = d == h ? d : e;
+            out1[2 * x + 1] = h == f ? f : e;
+        }
+        else
+        {
+            out0[2 * x] = out0[2 * x + 1] = out1[2 * x] = out1[2 * x + 1] = e;
+        }
+    }
+
+    // Scale3x over the 3x3 neighbourhood
+    //   A B C
+    //   D E F
+    //   G H I
+    // Scalar only.
+    static void scale3xRow(const Pixel* up, const Pixel* row, const Pixel* down, int width, Pixel* out,
+                           std::size_t stride)
+    {
+        Pixel* out0 = out;
+        Pixel* out1 = out + stride;
+        Pixel* out2 = out + 2 * stride;
+
+        for (int x = 0; x < width; x++)
+        {
+            const int left = std::max(x - 1, 0);
+            const int right = std::min(x + 1, width - 1);
+
+            const Pixel a = up[left], b = up[x], c = up[right];
+            const Pixel d = row[left], e = row[x], f = row[right];
+            const Pixel g = down[left], h = down[x], i = down[right];
+
+            Pixel* o0 = out0 + 3 * x;
+            Pixel* o1 = out1 + 3 * x;
+            Pixel* o2 = out2 + 3 * x;
+
+            if (b != h && d != f)
+            {
+                o0[0] = d == b ? d : e;
+                o0[1] = (d == b && e != c) || (b == f && e != a) ? b : e;
+                o0[2] = b == f ? f : e;
+                o1[0] = (d == b && e != g) || (d == h && e != a) ? d : e;
+                o1[1] = e;
+                o1[2] = (b == f && e != i) || (h == f && e != c) ? f : e;
+                o2[0] = d == h ? d : e;
+                o2[1] = (d == h && e != i) || (h == f && e != g) ? h : e;
+                o2[2] = h == f ? f : e;
+            }
+            else
+            {
+                std::fill_n(o0, 3, e);
+                std::fill_n(o1, 3, e);
+                std::fill_n(o2, 3, e);
+            }
+        }
+    }
+
+#if defined(SCALER_SSE2)
+    using Vec = __m128i;
+
+    static constexpr int lanes{16 / sizeof(Pixel)};
+
+    static Vec load(const Pixel* in)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    }
+
+    static void store(Pixel* out, Vec v)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+    }
+
+    static Vec eq(Vec a, Vec b)
+    {
+        if constexpr (sizeof(Pixel) == 1)
+        {
+            return _mm_cmpeq_epi8(a, b);
+        }
+        else if constexpr (sizeof(Pixel) == 2)
+        {
+            return _mm_cmpeq_epi16(a, b);
+        }
+        else
+        {
+            return _mm_cmpeq_epi32(a, b);
+        }
+    }
+
+    static Vec zipLo(Vec a, Vec b)
+    {
+        if constexpr (sizeof(Pixel) == 1)
+        {
+            return _mm_unpacklo_epi8(a, b);
+        }
+        else if constexpr (sizeof(Pixel) == 2)
+        {
+            return _mm_unpacklo_epi16(a, b);
+        }
+        else
+        {
+            return _mm_unpacklo_epi32(a, b);
+        }
+    }
+
+    static Vec zipHi(Vec a, Vec b)
+    {
+        if constexpr (sizeof(Pixel) == 1)
+        {
+            return _mm_unpackhi_epi8(a, b);
+        }
+        else if constexpr (sizeof(Pixel) == 2)
+        {
+            return _mm_unpackhi_epi16(a, b);
+        }
+        else
+        {
+            return _mm_unpackhi_epi32(a, b);
+        }
+    }
+
+    static Vec either(Vec a, Vec b)
+    {
+        return _mm_or_si128(a, b);
+    }
+
+    // b where mask is clear.
+    static Vec unless(Vec mask, Vec b)
+    {
+        return _mm_andnot_si128(mask, b);
+    }
+
+    static Vec select(Vec mask, Vec a, Vec b)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+#elif defined(SCALER_NEON)
+    using Vec = uint8x16_t;
+
+    static constexpr int lanes{16 / sizeof(Pixel)};
+
+    static Vec load(const Pixel* in)
+    {
+        return vld1q_u8(reinterpret_cast<const std::uint8_t*>(in));
+    }
+
+    static void store(Pixel* out, Vec v)
+    {
+        vst1q_u8(reinterpret_cast<std::uint8_t*>(out), v);
+    }
+
+    static Vec eq(Vec a, Vec b)
+    {
+        if constexpr (sizeof(Pixel) == 1)
+        {
+            return vceqq_u8(a, b);
+        }
+        else if constexpr (sizeof(Pixel) == 2)
+        {
+            return vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+        }
+        else
+        {
+            return vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+        }
+    }
+
+    static Vec zipLo(Vec a, Vec b)
+    {
+        if constexpr (sizeof(Pixel) == 1)
+        {
+            return vzip1q_u8(a, b);
+        }
+        else if constexpr (sizeof(Pixel) == 2)
+        {
+            return vreinterpretq_u8_u16(vzip1q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+        }
+        else
+        {
+            return vreinterpretq_u8_u32(vzip1q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+        }
+    }
+
+    static Vec zipHi(Vec a, Vec b)
+    {
+        if constexpr (sizeof(Pixel) == 1)
+        {
+            return vzip2q_u8(a, b);
+        }
+        else if constexpr (sizeof(Pixel) == 2)
+        {
+            return vreinterpretq_u8_u16(vzip2q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+        }
+        else
+        {
+            return vreinterpretq_u8_u32(vzip2q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+        }
+    }
+
+    static Vec either(Vec a, Vec b)
+    {
+        return vorrq_u8(a, b);
+    }
+
+    // b where mask is clear.
+    static Vec unless(Vec mask, Vec b)
+    {
+        return vbicq_u8(b, mask);
+    }
+
+    static Vec select(Vec mask, Vec a, Vec b)
+    {
+        return vbslq_u8(mask, a, b);
+    }
+#endif
+
+    std::vector<Pixel> ring;
+};
@@ -0,0 +1,140 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Calendar of timed events, one slot per event kind. The CPU runs until
+// the nearest deadline, so a peripheral with its own event adds nothing
+// to the per-instruction cost.
+class Scheduler
+{
+  public:
+    enum class Event : std::uint8_t
+    {
+        FrameEnd = 0,
+        IntEnd,
+        Scanline,
+        Break,
+        Count
+    };
+
+    static constexpr int never{std::numeric_limits<int>::max()};
+
+    // How far an instruction can carry the clock past the frame end before
+    // the clock is rebased. Per-tstate tables are this much longer.
+    static constexpr int maxOverrun{64};
+    static constexpr std::size_t eventCount{static_cast<std::size_t>(Event::Count)};
+
+    Scheduler() : now_{0}, deadline_{never}, next{Event::FrameEnd}
+    {
+        times.fill(never);
+    }
+
+    Scheduler(const Scheduler&) = delete;
+
+    int now() const
+    {
+        return now_;
+    }
+
+    int deadline() const
+    {
+        return deadline_;
+    }
+
+    bool due() const
+    {
+        return now_ >= deadline_;
+    }
+
+    void advance(int cycles)
+    {
+        now_ += cycles;
+    }
+
+    bool pending(Event event) const
+    {
+        return times[index(event)] != never;
+    }
+
+    void schedule(Event event, int at)
+    {
+        times[index(event)] = at;
+        if (at < deadline_)
+        {
+            deadline_ = at;
+            next = event;
+        }
+        else if (event == next)
+        {
+            update();
+        }
+    }
+
+    void cancel(Event event)
+    {
+        schedule(event, never);
+    }
+
+    Event pop()
+    {
+        const Event event = next;
+        times[index(event)] = never;
+        update();
+        return event;
+    }
+
+    void rebase(int cycles)
+    {
+        now_ -= cycles;
+        for (auto& time : times)
+        {
+            if (time != never)
+            {
+                time -= cycles;
+            }
+        }
+        update();
+    }
+
+  private:
+    static constexpr std::size_t index(Event event)
+    {
+        return static_cast<std::size_t>(event);
+    }
+
+    void update()
+    {
+        deadline_ = never;
+        for (std::size_t i = 0; i < times.size(); i++)
+        {
+            if (times[i] < deadline_)
+            {
+                deadline_ = times[i];
+                next = Event(i);
+            }
+        }
+    }
+
+    int now_;
+    int deadline_;
+    Event next;
+    std::array<int, eventCount> times;
+};
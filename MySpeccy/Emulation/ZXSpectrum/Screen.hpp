@@ -15,195 +15,822 @@
 //
 #pragma once
 
+#include <algorithm>
 #include <array>
-#include <cmath>
 #include <cstdint>
+#include <span>
+#include <vector>
 
 #include "Interfaces/API.hpp"
 #include "Interfaces/IBorderCtrl.hpp"
-#include "Interfaces/IBus.hpp"
-#include "Interfaces/IVSyncCtrl.hpp"
-
-class Screen : public IBorderCtrl
+#include "Interfaces/IDisplayModeCtrl.hpp"
+#include "Interfaces/IScreenCtrl.hpp"
+#include "ZXSpectrum/DirtyCells.hpp"
+#include "ZXSpectrum/FrameBuffers.hpp"
+#include "ZXSpectrum/OctetRenderer.hpp"
+#include "ZXSpectrum/Scheduler.hpp"
+
+// Renders lazily: the beam position is only caught up with the clock when
+// screen memory or the displayed bank is about to change, and at the end
+// of the frame. Border changes are only logged with their tstate and the
+// border is composed from that log in a few fills once the frame is over.
+// Only cells marked dirty are redrawn.
+//
+// Frames go to one of the internal buffers or, when the host provides one,
+// straight into its memory. The destination is picked when drawing of a
+// frame starts.
+//
+// Each video mode has its own octet loop, specialised at compile time.
+// A mode change catches up first and then swaps the loop, so the
+// standard screen runs the same code it always did.
+template <typename Model, typename Format = Rgb555>
+class Screen : public IBorderCtrl, public IScreenCtrl, public IDisplayModeCtrl
 {
   public:
-    using Pixel = uint16_t;
-
-    static constexpr int colorBits{5};
-    static constexpr int nonBrightLevelLinear{0x15};
-
-    static constexpr int colorMask{(1 << colorBits) - 1};
-    static constexpr int nonBrightMask{(nonBrightLevelLinear) | (nonBrightLevelLinear << (colorBits)) |
-                                       (nonBrightLevelLinear << (colorBits * 2))};
+    using Renderer = OctetRenderer<Format>;
+    using Pixel = typename Renderer::Pixel;
 
-    static constexpr int lineBlankCycles{48};
-    static constexpr int totalLineCycles{224};
-    static constexpr int frameBlankCycles{5488};
-    static constexpr int totalFrameCycles{70000};
+    static constexpr int totalLineCycles{Model::totalLineCycles};
+    static constexpr int totalFrameCycles{Model::totalFrameCycles};
+    static constexpr int cyclesToFirstByte{Model::cyclesToFirstByte};
     static constexpr int pixelsPerCycle{2};
-    static constexpr int cyclesToFirstByte{14336};
+
+    // Positions and widths along a line are in beam pixels, two to a
+    // tstate. The Timex hi-res mode puts two output pixels in each, so
+    // models with the SCLD output frames twice as wide.
+    static constexpr int xScale{Model::timexScreen ? 2 : 1};
 
     static constexpr int borderWidth{48};
     static constexpr int borderHeight{48};
-    static constexpr int frameWidth{352};
+    static constexpr int beamWidth{352};
+    static constexpr int frameWidth{beamWidth * xScale};
     static constexpr int frameHeight{288};
     static constexpr int screenWidth{256};
     static constexpr int screenHeight{192};
+    static constexpr int attributeBase{3 * 8 * 8 * 32};
+    static constexpr int fileSize{attributeBase + 24 * 32};
+
+    // Timex modes take their second half, or the whole picture, from a
+    // display file 0x2000 bytes up.
+    static constexpr int timexBase{0x2000};
+    static constexpr int displaySize{Model::timexScreen ? timexBase + fileSize : fileSize};
+
+    // Palette formats have no way to show ULAplus colours and stay with
+    // the standard ones.
+    static constexpr bool paletteSupported{requires { Format::rgb(0, 0, 0); }};
 
     static constexpr int topLeftCornerCycles{cyclesToFirstByte - borderWidth / pixelsPerCycle -
                                              totalLineCycles * borderHeight};
-    static constexpr int lineCycles{frameWidth / pixelsPerCycle};
+    static constexpr int lineCycles{beamWidth / pixelsPerCycle};
+    static constexpr int lineBlankCycles{totalLineCycles - lineCycles};
     static constexpr int bottomRightCornerCycles{topLeftCornerCycles + totalLineCycles * frameHeight - lineBlankCycles};
     static constexpr int octetCycles{8 / pixelsPerCycle};
 
-    static constexpr FrameInfo frameInfo{
-        .width = frameWidth, .height = frameHeight, .bytesPerRow = frameWidth * sizeof(Pixel)};
-
-    Screen(const IBus& memory, IVSyncCtrl& vSync)
-        : buffer{}, vSyncCtrl{vSync}, memory{memory}, cycles{0}, frame{0}, border{7}, flash{0}
+    static constexpr int cellColumns{beamWidth / 8};
+    static constexpr int cellWidth{8 * xScale};
+    static constexpr int cellRows{frameHeight / 8};
+    static constexpr DirtyRect fullFrame{.x = 0, .y = 0, .width = frameWidth, .height = frameHeight};
+
+    static constexpr FrameInfo frameInfo{.width = frameWidth,
+                                         .height = frameHeight,
+                                         .bytesPerRow = frameWidth * sizeof(Pixel),
+                                         .format = Format::format};
+
+    explicit Screen(const Scheduler& clock)
+        : clock{clock}, vram{nullptr}, cycles{0}, frame{0}, border{7}, flash{0}, buffers{},
+          composedLines{0}, composedColor{7}, composedChanges{0}, requested{}, output{}, lastTarget{},
+          bounds{fullFrame}, finished{buffers.backBuffer(), frameWidth, fullFrame}, started{false}, retargeted{false},
+          mode{Mode::Standard}, timexMode{0}, paletteEnabled{false}, plusColors{}, plusAttributes{},
+          hiResColors{Renderer::attributes[0][hiResAttribute(0)]}, drawSpan{&Screen::drawOctets<Mode::Standard, false>}
     {
     }
 
     Screen(const Screen&) = delete;
 
+    // Frames not yet started are drawn into caller memory: row y of the
+    // crop goes to pixels + y * bytesPerRow. The crop's x and width are
+    // rounded down to whole cells, an empty crop means the whole frame
+    // and a null pointer returns to the internal buffers. While the same
+    // destination comes back frame after frame only changed cells are
+    // redrawn, so it has to keep what was drawn into it.
+    void setTarget(void* pixels, std::size_t bytesPerRow, DirtyRect crop)
+    {
+        requested = {static_cast<Pixel*>(pixels), bytesPerRow / sizeof(Pixel), clip(crop)};
+    }
+
+    // Where the frame currently being drawn goes.
     Pixel* pixels()
     {
-        return &buffer[0];
+        begin();
+        return output.pixels;
+    }
+
+    // Size of the frame being drawn, at the origin of pixels().
+    const DirtyRect& outputBounds()
+    {
+        begin();
+        return bounds;
     }
 
-    void setBorder(int border) final override
+    // The last completed frame.
+    const Pixel* publishedPixels() const
     {
-        this->border = border & 7;
+        return finished.pixels;
     }
 
-    void runCycles(const int cyclesToRun)
+    // Row stride in pixels and size of the last completed frame.
+    std::size_t publishedStride() const
     {
-        const int finalCycles = cycles + cyclesToRun;
+        return finished.stride;
+    }
 
-        if (finalCycles > totalFrameCycles)
+    int publishedWidth() const
+    {
+        return finished.crop.width;
+    }
+
+    int publishedHeight() const
+    {
+        return finished.crop.height;
+    }
+
+    // May be called from another thread; see FrameBuffers.
+    const Pixel* acquireFrame()
+    {
+        return buffers.acquire();
+    }
+
+    void releaseFrame()
+    {
+        buffers.release();
+    }
+
+    // Rectangles redrawn during the last completed frame, relative to its
+    // crop.
+    std::span<const DirtyRect> dirtyRects() const
+    {
+        return rects;
+    }
+
+    void setBorder(int border, int cycle) final override
+    {
+        if ((border & 7) != this->border)
         {
-            const int toEnd = totalFrameCycles - cycles;
-            const int inNextFrame = cyclesToRun - toEnd;
+            this->border = border & 7;
+            borderChanges.push_back({clock.now() + cycle, this->border});
+            markBorder();
+        }
+    }
+
+    void setScreenMemory(const std::uint8_t* screen, int cycle) final override
+    {
+        catchUp(clock.now() + cycle);
+        if (screen != vram)
+        {
+            vram = screen;
+            markPaper();
+        }
+    }
+
+    void beforeScreenWrite(int offset, int cycle) final override
+    {
+        if constexpr (Model::timexScreen)
+        {
+            // The upper file is only on screen in a Timex mode.
+            if (offset >= timexBase ? mode == Mode::Standard : offset >= fileSize)
+            {
+                return;
+            }
+            offset &= timexBase - 1;
+        }
+
+        catchUp(clock.now() + cycle);
+        markOffset(offset);
+    }
+
+    void setTimexMode(int value, int cycle) final override
+    {
+        if constexpr (Model::timexScreen)
+        {
+            if (value == timexMode)
+            {
+                return;
+            }
+
+            beforeModeChange(clock.now() + cycle);
+            timexMode = std::uint8_t(value);
+            mode = timexScreenMode(value);
+            hiResColors = Renderer::attributes[0][hiResAttribute(value)];
+            selectKernel();
+        }
+    }
+
+    void setPaletteEntry(int index, int value, int cycle) final override
+    {
+        if constexpr (paletteSupported)
+        {
+            if (paletteEnabled)
+            {
+                beforeModeChange(clock.now() + cycle);
+            }
 
-            runCycles(toEnd);
+            plusColors[index & 63] = plusColor(value);
+            for (int attr = 0; attr < 256; attr++)
+            {
+                const int group = (attr >> 6) * 16;
+                plusAttributes[attr] = {plusColors[group + (attr & 7)], plusColors[group + 8 + ((attr >> 3) & 7)]};
+            }
+        }
+    }
 
-            cycles = 0;
-            frame++;
-            if (frame >= 50)
+    void setPaletteEnabled(bool enabled, int cycle) final override
+    {
+        if constexpr (paletteSupported)
+        {
+            if (enabled != paletteEnabled)
             {
-                frame = 0;
+                beforeModeChange(clock.now() + cycle);
+                paletteEnabled = enabled;
+                selectKernel();
             }
-            flash = frame < 25;
-            vSyncCtrl.vSync(toEnd);
+        }
+    }
 
-            runCycles(inNextFrame);
+    void catchUp()
+    {
+        catchUp(clock.now());
+    }
 
+    // Draws what the beam has scanned up to tstate now.
+    void catchUp(int now)
+    {
+        if (now <= cycles)
+        {
             return;
         }
 
-        if (finalCycles >= topLeftCornerCycles + octetCycles && cycles >= topLeftCornerCycles &&
-            cycles < bottomRightCornerCycles)
+        begin();
+        const int from = std::max(cycles, topLeftCornerCycles);
+        if (from < bottomRightCornerCycles)
         {
-            const int screenOctet = (cycles - topLeftCornerCycles) / octetCycles;
-            const int finalOctet = (finalCycles - topLeftCornerCycles) / octetCycles;
+            const int screenOctet = (from - topLeftCornerCycles) / octetCycles;
+            const int finalOctet = (now - topLeftCornerCycles) / octetCycles;
 
-            drawOctets(screenOctet, finalOctet);
+            (this->*drawSpan)(screenOctet, finalOctet);
         }
 
-        cycles = finalCycles;
+        cycles = now;
+    }
+
+    // Tstate by which output line `line` has been fully scanned.
+    static constexpr int lineDoneCycles(int line)
+    {
+        return topLeftCornerCycles + line * totalLineCycles + lineCycles;
+    }
+
+    // Completes the first `lines` output lines of the frame being drawn,
+    // border included, so they can be presented before the frame ends.
+    // The beam must already be past them.
+    void finishLines(int lines)
+    {
+        catchUp();
+        composeBorder(std::min(lines, frameHeight));
+    }
+
+    // Expects the previous frame to have been caught up before the clock
+    // was rebased.
+    void newFrame(int cyclesInFrame)
+    {
+        composeBorder(frameHeight);
+        borderChanges.clear();
+        composedLines = 0;
+        composedColor = border;
+        composedChanges = 0;
+
+        const bool external = output.pixels != buffers.backBuffer();
+        finished = output;
+        if (!external)
+        {
+            buffers.publish();
+        }
+
+        cells.endFrame(rects);
+        if (external)
+        {
+            cropRects();
+        }
+        started = false;
+
+        cycles = cyclesInFrame;
+        frame++;
+        if (frame >= 50)
+        {
+            frame = 0;
+        }
+
+        const std::uint8_t phase = frame < 25;
+        if (phase != flash)
+        {
+            flash = phase;
+            markFlashing();
+        }
     }
 
   private:
-    void drawOctets(int screenOctet, const int finalOctet)
+    static constexpr int paperColumn{borderWidth / 8};
+    static constexpr int paperRow{borderHeight / 8};
+    static constexpr int paperColumns{screenWidth / 8};
+    static constexpr int paperRows{screenHeight / 8};
+
+    using Buffers = FrameBuffers<Pixel, frameWidth * frameHeight>;
+
+    // Caller memory is tracked as one more buffer after the internal ones.
+    static constexpr int targetBuffer{Buffers::count};
+    using Cells = DirtyCells<cellColumns, cellRows, targetBuffer + 1, cellWidth>;
+
+    // Stride is in pixels.
+    struct Target
     {
-        int line = screenOctet / (totalLineCycles / octetCycles);
-        int lineOctet = screenOctet % (totalLineCycles / octetCycles);
+        Pixel* pixels;
+        std::size_t stride;
+        DirtyRect crop;
+    };
 
-        while (screenOctet < finalOctet)
+    static constexpr DirtyRect clip(DirtyRect crop)
+    {
+        if (crop.width == 0 || crop.height == 0)
         {
-            if (lineOctet >= (lineCycles / octetCycles))
+            return fullFrame;
+        }
+
+        const int x = std::min(crop.x / cellWidth * cellWidth, frameWidth);
+        const int y = std::min(int(crop.y), frameHeight);
+        const int width = std::min(crop.width / cellWidth * cellWidth, frameWidth - x);
+        const int height = std::min(int(crop.height), frameHeight - y);
+        return {.x = std::uint16_t(x), .y = std::uint16_t(y), .width = std::uint16_t(width),
+                .height = std::uint16_t(height)};
+    }
+
+    void begin()
+    {
+        if (started)
+        {
+            return;
+        }
+        started = true;
+
+        if (requested.pixels == nullptr)
+        {
+            output = {buffers.backBuffer(), frameWidth, fullFrame};
+            cells.drawInto(buffers.backIndex());
+        }
+        else
+        {
+            output = requested;
+            cells.drawInto(targetBuffer);
+
+            const Target& last = lastTarget;
+            retargeted = last.pixels != output.pixels || last.stride != output.stride ||
+                         last.crop.x != output.crop.x || last.crop.y != output.crop.y ||
+                         last.crop.width != output.crop.width || last.crop.height != output.crop.height;
+            if (retargeted)
             {
-                ++line;
-                if (line >= frameHeight)
-                    break;
-                screenOctet = line * (totalLineCycles / octetCycles);
-                lineOctet = 0;
-                continue;
+                cells.redraw();
+                lastTarget = output;
+            }
+        }
+        bounds = {.x = 0, .y = 0, .width = output.crop.width, .height = output.crop.height};
+    }
+
+    // Moves the frame's rectangles into the crop's coordinates; a new
+    // destination was drawn in full.
+    void cropRects()
+    {
+        if (retargeted)
+        {
+            rects.assign(1, bounds);
+            return;
+        }
+
+        const DirtyRect& crop = output.crop;
+        std::erase_if(rects, [&](DirtyRect& rect) {
+            const int left = std::max(rect.x, crop.x);
+            const int top = std::max(rect.y, crop.y);
+            const int right = std::min(rect.x + rect.width, crop.x + crop.width);
+            const int bottom = std::min(rect.y + rect.height, crop.y + crop.height);
+            if (left >= right || top >= bottom)
+            {
+                return true;
             }
 
-            drawOctet(line, lineOctet);
+            rect = {.x = std::uint16_t(left - crop.x), .y = std::uint16_t(top - crop.y),
+                    .width = std::uint16_t(right - left), .height = std::uint16_t(bottom - top)};
+            return false;
+        });
+    }
+
+    Pixel* at(int line, int x)
+    {
+        return output.pixels + std::size_t(line - output.crop.y) * output.stride + (x - output.crop.x);
+    }
+
+    static constexpr typename Cells::Row paperMask{((typename Cells::Row{1} << paperColumns) - 1) << paperColumn};
 
-            ++screenOctet;
-            ++lineOctet;
+    void markBorder()
+    {
+        for (int row = 0; row < cellRows; row++)
+        {
+            const bool paperLine = row >= paperRow && row < paperRow + paperRows;
+            cells.markRow(row, paperLine ? Cells::allColumns & ~paperMask : Cells::allColumns);
         }
     }
 
-    void drawOctet(int line, int lineOctet)
+    void markPaper()
     {
-        const int octetBase = line * frameWidth + lineOctet * 8;
+        for (int row = paperRow; row < paperRow + paperRows; row++)
+        {
+            cells.markRow(row, paperMask);
+        }
+    }
 
-        if (line < borderHeight || line >= borderHeight + screenHeight || lineOctet < borderWidth / 8 ||
-            lineOctet >= borderWidth / 8 + screenWidth / 8)
+    // Marks the cell showing a byte of the display file.
+    void markOffset(int offset)
+    {
+        if (offset < attributeBase)
         {
-            const Pixel borderColor = makeColor(border) & nonBrightMask;
-            for (int i = 0; i < 8; i++)
+            const int row = ((offset >> 11) & 3) * 8 + ((offset >> 5) & 7);
+            cells.mark(paperColumn + (offset & 31), paperRow + row);
+        }
+        else
+        {
+            const int cell = offset - attributeBase;
+            cells.mark(paperColumn + (cell & 31), paperRow + (cell >> 5));
+        }
+    }
+
+    // ULAplus uses the FLASH bit to pick a palette, and hi-res has no
+    // attributes at all.
+    void markFlashing()
+    {
+        if (vram == nullptr || paletteEnabled || mode == Mode::HiRes)
+        {
+            return;
+        }
+
+        const int first = mode == Mode::HiColour ? 0 : attributeBase;
+        const int last = mode == Mode::HiColour ? attributeBase : fileSize;
+        const std::uint8_t* attributes = vram + (mode == Mode::Standard ? 0 : timexBase);
+        for (int offset = first; offset < last; offset++)
+        {
+            if ((attributes[offset] & 0x80) != 0)
             {
-                buffer[octetBase + i] = borderColor;
+                markOffset(offset);
             }
+        }
+    }
+
+    enum class Mode : std::uint8_t
+    {
+        Standard,
+        Alternate,
+        HiColour,
+        HiRes
+    };
+
+    // Bit 0 shows the second display file; bit 1 takes 8x1 attributes from
+    // it, or with bit 2 as well its bytes interleave with the first at
+    // double width.
+    static constexpr Mode timexScreenMode(int value)
+    {
+        if ((value & 6) == 6)
+        {
+            return Mode::HiRes;
+        }
+        if ((value & 2) != 0)
+        {
+            return Mode::HiColour;
+        }
+        return (value & 1) != 0 ? Mode::Alternate : Mode::Standard;
+    }
+
+    // Hi-res ink from bits 3-5 on the complementary paper.
+    static constexpr int hiResAttribute(int value)
+    {
+        const int ink = (value >> 3) & 7;
+        return (7 - ink) << 3 | ink;
+    }
+
+    // GGGRRRBB, with the missing low bit of blue set when either of the
+    // others is.
+    static constexpr Pixel plusColor(int value)
+    {
+        const auto expand = [](int level) { return level << 5 | level << 2 | level >> 1; };
+        const int blue = (value & 3) << 1 | ((value & 3) != 0 ? 1 : 0);
+        return Format::rgb(expand((value >> 2) & 7), expand((value >> 5) & 7), expand(blue));
+    }
+
+    // Whatever the beam has shown so far keeps the old colours; the rest of
+    // the frame is redrawn in the new ones.
+    void beforeModeChange(int now)
+    {
+        catchUp(now);
+        composeBorder(linesDone(now));
+        markBorder();
+        markPaper();
+    }
+
+    static int linesDone(int now)
+    {
+        if (now < lineDoneCycles(0))
+        {
+            return 0;
+        }
+        return std::min((now - lineDoneCycles(0)) / totalLineCycles + 1, frameHeight);
+    }
+
+    // Only instantiates the loops a model and format can use.
+    void selectKernel()
+    {
+        if constexpr (Model::timexScreen)
+        {
+            switch (mode)
+            {
+            case Mode::Alternate:
+                drawSpan = pick<Mode::Alternate>();
+                return;
+
+            case Mode::HiColour:
+                drawSpan = pick<Mode::HiColour>();
+                return;
+
+            case Mode::HiRes:
+                drawSpan = &Screen::drawOctets<Mode::HiRes, false>;
+                return;
+
+            default:
+                break;
+            }
+        }
+        drawSpan = pick<Mode::Standard>();
+    }
+
+    template <Mode kernelMode> auto pick() const
+    {
+        if constexpr (paletteSupported)
+        {
+            if (paletteEnabled)
+            {
+                return &Screen::drawOctets<kernelMode, true>;
+            }
+        }
+        return &Screen::drawOctets<kernelMode, false>;
+    }
+
+    Pixel borderPixel(std::uint8_t color) const
+    {
+        if constexpr (Model::timexScreen)
+        {
+            if (mode == Mode::HiRes)
+            {
+                return hiResColors.paper;
+            }
+        }
+        if constexpr (paletteSupported)
+        {
+            if (paletteEnabled)
+            {
+                return plusColors[8 + color];
+            }
+        }
+        return Renderer::borderColor(color);
+    }
+
+    struct BorderChange
+    {
+        int cycles;
+        std::uint8_t color;
+    };
+
+    static constexpr int octetsPerLine{totalLineCycles / octetCycles};
+
+    // Only paper octets are drawn as the beam goes; the border is left to
+    // composeBorder().
+    template <Mode kernelMode, bool plus> void drawOctets(int screenOctet, const int finalOctet)
+    {
+        const DirtyRect& crop = output.crop;
+        const int firstLine = std::max({screenOctet / octetsPerLine, borderHeight, int(crop.y)});
+        const int lastLine =
+            std::min({finalOctet / octetsPerLine, borderHeight + screenHeight - 1, crop.y + crop.height - 1});
+
+        for (int line = firstLine; line <= lastLine; line++)
+        {
+            const int lineStart = line * octetsPerLine;
+            const int first = std::max({screenOctet - lineStart, paperColumn, crop.x / cellWidth});
+            const int last =
+                std::min({finalOctet - lineStart, paperColumn + paperColumns, (crop.x + crop.width) / cellWidth});
+
+            for (int lineOctet = first; lineOctet < last; lineOctet++)
+            {
+                drawOctet<kernelMode, plus>(line, lineOctet);
+            }
+        }
+    }
+
+    template <Mode kernelMode, bool plus> void drawOctet(int line, int lineOctet)
+    {
+        if (!cells.dirty(lineOctet, line / 8))
+        {
             return;
         }
 
-        const int screenLine = line - borderHeight;
-        const int charInLine = lineOctet - borderWidth / 8;
+        Pixel* out = at(line, lineOctet * cellWidth);
 
-        const int third = (screenLine >> 6) & 3;
-        const int lineInChar = screenLine & 7;
-        const int charLine = screenLine >> 3;
+        const int screenLine = line - borderHeight;
+        const int charInLine = lineOctet - paperColumn;
+        const int bitmap = lines.pixels[screenLine] + charInLine;
 
-        const int pixelAddr = (third << 11) | (lineInChar << 8) | ((charLine & 7) << 5) | charInLine;
-        const int attributeAddr = attributeBase + charLine * 32 + charInLine;
+        if constexpr (kernelMode == Mode::HiRes)
+        {
+            // 16 pixels to an octet, the byte from the first file on the
+            // left.
+            Renderer::draw(out, vram[bitmap], hiResColors);
+            Renderer::draw(out + 8, vram[timexBase + bitmap], hiResColors);
+        }
+        else
+        {
+            constexpr int file = kernelMode == Mode::Alternate ? timexBase : 0;
+            const std::uint8_t pixs = vram[file + bitmap];
+            const std::uint8_t attrs = kernelMode == Mode::HiColour
+                                           ? vram[timexBase + bitmap]
+                                           : vram[file + lines.attributes[screenLine] + charInLine];
 
-        int pixs = memory.read(pixelAddr);
-        const int attrs = memory.read(attributeAddr);
+            if constexpr (plus)
+            {
+                drawWide(out, pixs, plusAttributes[attrs]);
+            }
+            else
+            {
+                drawWide(out, pixs, Renderer::attributes[flash][attrs]);
+            }
+        }
+    }
 
-        const int flashState = flash & (attrs >> 7) & 1;
+    // An octet at the output width, each pixel repeated xScale times.
+    static void drawWide(Pixel* out, std::uint8_t pixs, typename Renderer::Colors colors)
+    {
+        if constexpr (xScale == 1)
+        {
+            Renderer::draw(out, pixs, colors);
+        }
+        else
+        {
+            Renderer::draw(out, std::uint8_t(doubled[pixs] >> 8), colors);
+            Renderer::draw(out + 8, std::uint8_t(doubled[pixs]), colors);
+        }
+    }
 
-        pixs = pixs ^ (0xFF * flashState);
+    // Replays the frame's border changes over the border area, carrying on
+    // from where the last call stopped. A change shows from the octet the
+    // beam was drawing when it happened.
+    void composeBorder(int lines)
+    {
+        begin();
+        const DirtyRect& crop = output.crop;
+        const int firstLine = std::max(composedLines, int(crop.y));
+        const int lastLine = std::min(lines, crop.y + crop.height);
 
-        for (int i = 0; i < 8; i++)
+        for (int line = firstLine; line < lastLine; line++)
         {
-            buffer[octetBase + i] = makePixel(attrs, ((pixs & 0x80) >> 7));
-            pixs <<= 1;
+            if (!cells.dirty(0, line / 8))
+            {
+                continue;
+            }
+
+            if (line < borderHeight || line >= borderHeight + screenHeight)
+            {
+                fillBorder(line, 0, cellColumns, composedColor, composedChanges);
+            }
+            else
+            {
+                fillBorder(line, 0, paperColumn, composedColor, composedChanges);
+                fillBorder(line, paperColumn + paperColumns, cellColumns, composedColor, composedChanges);
+            }
         }
+        composedLines = std::max(composedLines, lines);
     }
 
-    static Pixel makeColor(int index)
+    // Walks the whole run so the colour stays in step, but only writes the
+    // part inside the crop.
+    void fillBorder(int line, int first, int last, std::uint8_t& color, std::size_t& next)
     {
-        Pixel result = (index & 1) * colorMask;
-        result |= ((index & 2) * colorMask) << (colorBits * 2 - 1);
-        result |= ((index & 4) * colorMask) << (colorBits - 2);
+        const int lineStart = topLeftCornerCycles + line * totalLineCycles;
+        const int left = output.crop.x / cellWidth;
+        const int right = (output.crop.x + output.crop.width) / cellWidth;
+
+        int octet = first;
+        while (octet < last)
+        {
+            const int octetEnd = lineStart + (octet + 1) * octetCycles;
+            while (next < borderChanges.size() && borderChanges[next].cycles < octetEnd)
+            {
+                color = borderChanges[next++].color;
+            }
+
+            int runEnd = last;
+            if (next < borderChanges.size())
+            {
+                runEnd = std::clamp((borderChanges[next].cycles - lineStart) / octetCycles, octet + 1, last);
+            }
 
-        return result;
+            const int from = std::max(octet, left);
+            const int to = std::min(runEnd, right);
+            if (from < to)
+            {
+                std::fill(at(line, from * cellWidth), at(line, to * cellWidth), borderPixel(color));
+            }
+            octet = runEnd;
+        }
     }
 
-    static Pixel makePixel(int attr, int value)
+    struct LineTable
+    {
+        std::array<std::uint16_t, screenHeight> pixels;
+        std::array<std::uint16_t, screenHeight> attributes;
+    };
+
+    // Start of each screen line's bitmap and attribute rows in VRAM.
+    static const LineTable lines;
+
+    // Each bit of a byte repeated, for drawing octets at double width.
+    static const std::array<std::uint16_t, 256> doubled;
+
+    static constexpr std::array<std::uint16_t, 256> makeDoubled()
     {
-        Pixel color = makeColor(attr & 7) * value;
-        color |= makeColor((attr >> 3) & 7) * (value ^ 1);
+        std::array<std::uint16_t, 256> table{};
+        for (int bits = 0; bits < 256; bits++)
+        {
+            for (int bit = 0; bit < 8; bit++)
+            {
+                if (((bits >> bit) & 1) != 0)
+                {
+                    table[bits] |= std::uint16_t(3 << (bit * 2));
+                }
+            }
+        }
+        return table;
+    }
 
-        Pixel result = color & nonBrightMask;
-        result |= color * ((attr & 0x40) >> 6);
+    static constexpr LineTable makeLines()
+    {
+        LineTable table{};
+        for (int screenLine = 0; screenLine < screenHeight; screenLine++)
+        {
+            const int third = (screenLine >> 6) & 3;
+            const int lineInChar = screenLine & 7;
+            const int charLine = screenLine >> 3;
 
-        return result;
+            table.pixels[screenLine] = (third << 11) | (lineInChar << 8) | ((charLine & 7) << 5);
+            table.attributes[screenLine] = attributeBase + charLine * 32;
+        }
+        return table;
     }
 
-    std::array<Pixel, frameWidth * frameHeight> buffer;
-    const IBus& memory;
-    IVSyncCtrl& vSyncCtrl;
+    const Scheduler& clock;
+    const std::uint8_t* vram;
     int cycles;
     std::uint8_t frame;
     std::uint8_t border;
     std::uint8_t flash;
-
-    static constexpr int attributeBase = 3 * 8 * 8 * 32;
+    Buffers buffers;
+    Cells cells;
+    std::vector<DirtyRect> rects;
+    std::vector<BorderChange> borderChanges;
+    int composedLines;
+    std::uint8_t composedColor;
+    std::size_t composedChanges;
+    Target requested;
+    Target output;
+    Target lastTarget;
+    DirtyRect bounds;
+    Target finished;
+    bool started;
+    bool retargeted;
+
+    using Colors = typename Renderer::Colors;
+    using Span = void (Screen::*)(int, int);
+
+    Mode mode;
+    std::uint8_t timexMode;
+    bool paletteEnabled;
+    std::array<Pixel, 64> plusColors;
+    std::array<Colors, 256> plusAttributes;
+    Colors hiResColors;
+    Span drawSpan;
 };
+
+template <typename Model, typename Format>
+inline constexpr typename Screen<Model, Format>::LineTable Screen<Model, Format>::lines{
+    Screen<Model, Format>::makeLines()};
+
+template <typename Model, typename Format>
+inline constexpr std::array<std::uint16_t, 256> Screen<Model, Format>::doubled{Screen<Model, Format>::makeDoubled()};
@@ -0,0 +1,101 @@
+//      Copyright © 2025  Andrius Mazeikis
+//
+//      This program is free software: you can redistribute it and/or modify
+//      it under the terms of the GNU General Public License as published by
+//      the Free Software Foundation, either version 3 of the License, or
+//      (at your option) any later version.
+//
+//      This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY; without even the implied warranty of
+//      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//      GNU General Public License for more details.
+//
+//      You should have received a copy of the GNU General Public License
+//      along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include "Interfaces/API.hpp"
+#include "Scheduler.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Watched address and port ranges. Memory and IOBus only consult this
+// from the slow path of pages flagged as watched; a hit stops the frame
+// at the next instruction boundary.
+class Watchpoints
+{
+  public:
+    struct Hit
+    {
+        WatchKind kind;
+        std::uint16_t address;
+    };
+
+    Watchpoints(Scheduler& scheduler) : scheduler{scheduler}, hit{}
+    {
+    }
+
+    Watchpoints(const Watchpoints&) = delete;
+
+    void add(int kinds, int first, int last)
+    {
+        ranges.push_back({static_cast<std::uint8_t>(kinds), first & 0xFFFF, last & 0xFFFF});
+    }
+
+    void clear()
+    {
+        ranges.clear();
+    }
+
+    // Kinds watched anywhere in [first, last].
+    int kinds(int first, int last) const
+    {
+        int result = 0;
+        for (const auto& range : ranges)
+        {
+            if (range.first <= last && range.last >= first)
+            {
+                result |= range.kinds;
+            }
+        }
+        return result;
+    }
+
+    void check(WatchKind kind, int addr)
+    {
+        if (scheduler.pending(Scheduler::Event::Break))
+        {
+            return;
+        }
+
+        addr &= 0xFFFF;
+        for (const auto& range : ranges)
+        {
+            if ((range.kinds & kind) != 0 && addr >= range.first && addr <= range.last)
+            {
+                hit = {.kind = kind, .address = static_cast<std::uint16_t>(addr)};
+                scheduler.schedule(Scheduler::Event::Break, scheduler.now());
+                return;
+            }
+        }
+    }
+
+    Hit lastHit() const
+    {
+        return hit;
+    }
+
+  private:
+    struct Range
+    {
+        std::uint8_t kinds;
+        int first;
+        int last;
+    };
+
+    Scheduler& scheduler;
+    std::vector<Range> ranges;
+    Hit hit;
+};
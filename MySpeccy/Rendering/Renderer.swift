@@ -110,7 +110,7 @@ class Renderer: NSObject, MTKViewDelegate {
         }
     }
     
-    func updateImage(bytes: UnsafeMutableRawPointer) {
+    func updateImage(bytes: UnsafeRawPointer) {
         
         guard let task = taskToDraw ?? availableTasks.popLast() else { return }
         task.texture.replace(region: MTLRegion(origin: MTLOriginMake(0, 0, 0), size: MTLSize(width: width, height: height, depth: 1)), mipmapLevel: 0, withBytes: bytes, bytesPerRow: bytesPerRow)
@@ -63,7 +63,9 @@ class ViewController: NSViewController {
             frameData.audioBuffer.buffer = buffer.pointee.mAudioData.bindMemory(to: Float.self, capacity: bufferCapacity)
             frameData.audioBuffer.capacity = UInt32(bufferCapacity)
             self.machine.processFrame(&frameData)
-            self.renderer.updateImage(bytes: frameData.pixels)
+            if !frameData.unchanged {
+                self.renderer.updateImage(bytes: frameData.pixels)
+            }
             buffer.pointee.mAudioDataByteSize = frameData.audioSamplesProduced * UInt32(MemoryLayout<Float>.size)
         }
         